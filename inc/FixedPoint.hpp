@@ -0,0 +1,75 @@
+#pragma once
+#include <cstdint>
+
+// Signed decimal fixed point number. IntegerDigits bounds the range, which lets formatting know the
+// longest output at compile time. Values outside the range saturate.
+template<uint8_t Decimals, uint8_t IntegerDigits>
+class FixedPoint
+{
+public:
+    static_assert(Decimals <= 4 && IntegerDigits >= 1 && IntegerDigits + Decimals <= 9, "Must fit in int32_t");
+
+    static constexpr int32_t scale = []()
+    {
+        int32_t scale = 1;
+        for (uint8_t i = 0; i < Decimals; ++i)
+        {
+            scale *= 10;
+        }
+        return scale;
+    }();
+
+    static constexpr int32_t max_raw = []()
+    {
+        int32_t max = 1;
+        for (uint8_t i = 0; i < IntegerDigits + Decimals; ++i)
+        {
+            max *= 10;
+        }
+        return max - 1;
+    }();
+
+    constexpr FixedPoint() noexcept = default;
+
+    [[nodiscard]] static constexpr FixedPoint FromRaw(int32_t raw) noexcept
+    {
+        FixedPoint value;
+        value.m_raw = raw > max_raw ? max_raw : raw < -max_raw ? -max_raw : raw;
+        return value;
+    }
+
+    [[nodiscard]] constexpr int32_t Raw() const noexcept
+    {
+        return m_raw;
+    }
+
+    [[nodiscard]] constexpr bool IsNegative() const noexcept
+    {
+        return m_raw < 0;
+    }
+
+    // Magnitude of the integer part.
+    [[nodiscard]] constexpr uint32_t Whole() const noexcept
+    {
+        return Magnitude() / scale;
+    }
+
+    // Magnitude of the fractional part, in units of 10^-Decimals.
+    [[nodiscard]] constexpr uint32_t Fraction() const noexcept
+    {
+        return Magnitude() % scale;
+    }
+
+    constexpr bool operator==(const FixedPoint&) const noexcept = default;
+
+private:
+    int32_t m_raw = 0;
+
+    [[nodiscard]] constexpr uint32_t Magnitude() const noexcept
+    {
+        return static_cast<uint32_t>(m_raw < 0 ? -m_raw : m_raw);
+    }
+};
+
+// RHT03 readings are in tenths. Humidity is 0 - 100 % and temperature is -40 - 80 C.
+using Tenths = FixedPoint<1, 3>;
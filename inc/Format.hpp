@@ -0,0 +1,112 @@
+#pragma once
+#include "FixedPoint.hpp"
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+// Allocation free formatting of string literals and fixed point numbers. The longest possible output of the
+// arguments is checked against the buffer size at compile time, so the output is never truncated.
+//
+//     std::array<uint8_t, 16> buffer;
+//     auto length = FormatTo(buffer, "Temp: ", temp, "C");
+
+template<typename T>
+struct FormatWidth;
+
+template<size_t N>
+struct FormatWidth<char[N]>
+{
+    static constexpr size_t value = N - 1;
+};
+
+template<uint8_t Decimals, uint8_t IntegerDigits>
+struct FormatWidth<FixedPoint<Decimals, IntegerDigits>>
+{
+    static constexpr size_t value = 1 + IntegerDigits + (Decimals > 0 ? 1 + Decimals : 0);
+};
+
+template<typename CharT, size_t N>
+constexpr void FormatAppend(CharT* out, size_t& length, const char (&text)[N]) noexcept
+{
+    for (size_t i = 0; i + 1 < N && text[i] != '\0'; ++i)
+    {
+        out[length++] = static_cast<CharT>(text[i]);
+    }
+}
+
+template<typename CharT, uint8_t Decimals, uint8_t IntegerDigits>
+constexpr void FormatAppend(CharT* out, size_t& length, const FixedPoint<Decimals, IntegerDigits>& value) noexcept
+{
+    if (value.IsNegative())
+    {
+        out[length++] = static_cast<CharT>('-');
+    }
+
+    // Integer part without leading zeros, but always at least one digit.
+    std::array<char, IntegerDigits> digits{};
+    size_t digit_count = 0;
+    auto whole = value.Whole();
+    do
+    {
+        digits[digit_count++] = static_cast<char>('0' + whole % 10);
+        whole /= 10;
+    } while (whole != 0 && digit_count < digits.size());
+
+    while (digit_count > 0)
+    {
+        out[length++] = static_cast<CharT>(digits[--digit_count]);
+    }
+
+    if constexpr (Decimals > 0)
+    {
+        out[length++] = static_cast<CharT>('.');
+        auto divisor = FixedPoint<Decimals, IntegerDigits>::scale / 10;
+        auto fraction = value.Fraction();
+        for (uint8_t i = 0; i < Decimals; ++i)
+        {
+            out[length++] = static_cast<CharT>('0' + (fraction / divisor) % 10);
+            divisor /= 10;
+        }
+    }
+}
+
+// Returns the number of characters written. No null terminator is added.
+template<typename CharT, size_t N, typename... Args>
+[[nodiscard]] constexpr size_t FormatTo(std::array<CharT, N>& buffer, const Args&... args) noexcept
+{
+    static_assert(sizeof(CharT) == 1, "Buffer must be made of bytes");
+    static_assert((FormatWidth<Args>::value + ... + 0) <= N, "Buffer is too small for the longest output");
+
+    size_t length = 0;
+    (FormatAppend(buffer.data(), length, args), ...);
+    return length;
+}
+
+// The formatting is checked by the compiler, against the strings each value should produce.
+template<size_t N>
+constexpr bool FormatsAs(const Tenths& value, const char (&expected)[N]) noexcept
+{
+    std::array<char, FormatWidth<Tenths>::value> buffer{};
+    auto length = FormatTo(buffer, value);
+    if (length != N - 1)
+    {
+        return false;
+    }
+
+    for (size_t i = 0; i < length; ++i)
+    {
+        if (buffer[i] != expected[i])
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+static_assert(FormatsAs(Tenths::FromRaw(0), "0.0"));
+static_assert(FormatsAs(Tenths::FromRaw(5), "0.5"));
+static_assert(FormatsAs(Tenths::FromRaw(-5), "-0.5"));
+static_assert(FormatsAs(Tenths::FromRaw(453), "45.3"));
+static_assert(FormatsAs(Tenths::FromRaw(1000), "100.0"));
+static_assert(FormatsAs(Tenths::FromRaw(-401), "-40.1"));
+static_assert(FormatsAs(Tenths::FromRaw(123456), "999.9"));
@@ -0,0 +1,257 @@
+#pragma once
+#include <array>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+
+// Constexpr descriptors for GPIO pins. The port is an enum rather than a GPIO_TypeDef pointer so descriptors can be
+// used in constant expressions and as template arguments, and so the registers can come from somewhere else on host.
+// Nothing here needs the HAL. The MCU's registers are in HALPorts.hpp.
+
+enum class GPIOPort : uint8_t
+{
+    A,
+    B,
+    C,
+    Count
+};
+
+inline constexpr size_t gpio_port_count = static_cast<size_t>(GPIOPort::Count);
+
+struct GPIOPin
+{
+    GPIOPort port;
+    uint16_t pin;   // GPIO_PIN_x mask, 1 << x.
+};
+
+// BSRR word that sets or resets the pin.
+constexpr uint32_t MakePinWord(const GPIOPin& pin, bool set) noexcept
+{
+    return set ? pin.pin : static_cast<uint32_t>(pin.pin) << 16;
+}
+
+// Where the pins' registers come from. Ports::Regs(GPIOPort) returns a pointer to something with MODER, IDR and
+// BSRR members, and Ports::SetModes(regs, mask, mode) replaces the MODER bits in mask. The default is the MCU's,
+// in HALPorts.hpp, and a host test can pass a fake.
+struct HALPorts;
+
+// A single pin known at compile time. Each call is one register access.
+template<GPIOPin Pin, typename Ports = HALPorts>
+class IOPin
+{
+public:
+    static void Write(bool state) noexcept
+    {
+        Ports::Regs(Pin.port)->BSRR = MakePinWord(Pin, state);
+    }
+
+    [[nodiscard]] static bool Read() noexcept
+    {
+        return (Ports::Regs(Pin.port)->IDR & Pin.pin) != 0;
+    }
+};
+
+// Pins that carry a value together, where pin i is bit i. The ports and masks are worked out at compile time, so
+// writing a value is one BSRR store per port used and reading it is one IDR load per port used.
+template<const auto& Pins, typename Ports = HALPorts>
+class ParallelBus
+{
+public:
+    static constexpr size_t width = Pins.size();
+    static_assert(width <= 8, "Values are passed as uint8_t");
+
+    // BSRR word for each port. Ports without any of the pins have a zero word, which is a no-op.
+    using BSRRWords = std::array<uint32_t, gpio_port_count>;
+
+    static constexpr auto bsrr_table = []()
+    {
+        std::array<BSRRWords, 1u << width> table{};
+        for (size_t value = 0; value < table.size(); ++value)
+        {
+            for (size_t i = 0; i < width; ++i)
+            {
+                table[value][static_cast<size_t>(Pins[i].port)] |= MakePinWord(Pins[i], (value >> i) & 1);
+            }
+        }
+        return table;
+    }();
+
+    // True when pin i is bit first + i of a single port. The value is then shifted into place rather than looked
+    // up, so a write is one BSRR store and a read is one IDR load, whatever the pins.
+    static constexpr bool is_contiguous = []()
+    {
+        for (size_t i = 1; i < width; ++i)
+        {
+            if (Pins[i].port != Pins[0].port || Pins[i].pin != static_cast<uint32_t>(Pins[0].pin) << i)
+            {
+                return false;
+            }
+        }
+        return true;
+    }();
+
+    // Pins of each port.
+    static constexpr auto port_masks = []()
+    {
+        std::array<uint16_t, gpio_port_count> masks{};
+        for (const auto& pin : Pins)
+        {
+            masks[static_cast<size_t>(pin.port)] |= pin.pin;
+        }
+        return masks;
+    }();
+
+    // BSRR words Write() stores for a value.
+    [[nodiscard]] static constexpr BSRRWords Words(uint8_t value) noexcept
+    {
+        if constexpr (is_contiguous)
+        {
+            BSRRWords words{};
+            words[static_cast<size_t>(Pins[0].port)] = ContiguousWord(value);
+            return words;
+        }
+        return bsrr_table[value];
+    }
+
+    // Value Read() gathers from the IDR of each port.
+    [[nodiscard]] static constexpr uint8_t Gather(const std::array<uint32_t, gpio_port_count>& idr) noexcept
+    {
+        if constexpr (is_contiguous)
+        {
+            return static_cast<uint8_t>((idr[static_cast<size_t>(Pins[0].port)] >> first_bit) & value_mask);
+        }
+
+        uint8_t value = 0;
+        for (size_t i = 0; i < width; ++i)
+        {
+            const auto bit = (idr[static_cast<size_t>(Pins[i].port)] >> std::countr_zero(Pins[i].pin)) & 1;
+            value |= static_cast<uint8_t>(bit << i);
+        }
+        return value;
+    }
+
+    static void Write(uint8_t value) noexcept
+    {
+        if constexpr (is_contiguous)
+        {
+            Ports::Regs(Pins[0].port)->BSRR = ContiguousWord(value);
+            return;
+        }
+
+        const auto& words = bsrr_table[value];
+        for (size_t port = 0; port < gpio_port_count; ++port)
+        {
+            if (port_masks[port] != 0)
+            {
+                Ports::Regs(static_cast<GPIOPort>(port))->BSRR = words[port];
+            }
+        }
+    }
+
+    [[nodiscard]] static uint8_t Read() noexcept
+    {
+        if constexpr (is_contiguous)
+        {
+            return static_cast<uint8_t>((Ports::Regs(Pins[0].port)->IDR >> first_bit) & value_mask);
+        }
+
+        std::array<uint32_t, gpio_port_count> idr{};
+        for (size_t port = 0; port < gpio_port_count; ++port)
+        {
+            if (port_masks[port] != 0)
+            {
+                idr[port] = Ports::Regs(static_cast<GPIOPort>(port))->IDR;
+            }
+        }
+        return Gather(idr);
+    }
+
+    // Only MODER changes between the two directions. Pull, speed and output type are left as they are.
+    static void SetOutput(bool is_output) noexcept
+    {
+        for (size_t port = 0; port < gpio_port_count; ++port)
+        {
+            const auto& masks = moder_masks[port];
+            if (masks.mask != 0)
+            {
+                Ports::SetModes(Ports::Regs(static_cast<GPIOPort>(port)), masks.mask, is_output ? masks.output : 0);
+            }
+        }
+    }
+
+    // Checks the pins are single, distinct pins, then plays every value through emulated ports the way the
+    // hardware applies BSRR, from all pins low and from all pins high. Each value has to read back as written and
+    // leave the other pins of the ports alone.
+    static constexpr bool IsValid() noexcept
+    {
+        size_t pin_count = 0;
+        for (const auto& pin : Pins)
+        {
+            if (std::popcount(pin.pin) != 1)
+            {
+                return false;
+            }
+        }
+        for (auto mask : port_masks)
+        {
+            pin_count += static_cast<size_t>(std::popcount(mask));
+        }
+        if (pin_count != width)
+        {
+            return false;
+        }
+
+        for (uint32_t initial : std::array<uint32_t, 2>{ 0x0000, 0xFFFF })
+        {
+            for (size_t value = 0; value < (1u << width); ++value)
+            {
+                const auto words = Words(static_cast<uint8_t>(value));
+                std::array<uint32_t, gpio_port_count> odr{};
+                for (size_t port = 0; port < gpio_port_count; ++port)
+                {
+                    odr[port] = ((initial & ~(words[port] >> 16)) | words[port]) & 0xFFFFu;
+                    if (((odr[port] ^ initial) & ~static_cast<uint32_t>(port_masks[port])) != 0)
+                    {
+                        return false;
+                    }
+                }
+
+                if (Gather(odr) != value)
+                {
+                    return false;
+                }
+            }
+        }
+        return true;
+    }
+
+private:
+    static constexpr uint32_t value_mask = (1u << width) - 1;
+    static constexpr int first_bit = std::countr_zero(Pins[0].pin);
+
+    static constexpr uint32_t ContiguousWord(uint8_t value) noexcept
+    {
+        const uint32_t bits = value & value_mask;
+        return (bits << first_bit) | ((bits ^ value_mask) << (first_bit + 16));
+    }
+
+    // MODER bits of the pins on each port, and the value of those bits in output mode (01 per pin).
+    struct ModerMasks
+    {
+        uint32_t mask;
+        uint32_t output;
+    };
+
+    static constexpr auto moder_masks = []()
+    {
+        std::array<ModerMasks, gpio_port_count> masks{};
+        for (const auto& pin : Pins)
+        {
+            const auto shift = 2 * std::countr_zero(pin.pin);
+            auto& port = masks[static_cast<size_t>(pin.port)];
+            port.mask |= 0b11u << shift;
+            port.output |= 0b01u << shift;
+        }
+        return masks;
+    }();
+};
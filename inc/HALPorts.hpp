@@ -0,0 +1,34 @@
+#pragma once
+#include "GPIOPin.hpp"
+#include "stm32l4xx_hal.h"
+
+// Replaces the MODER bits in mask with mode. Pins of one port share MODER and their modes change from both
+// interrupts and the main loop, so the read-modify-write runs with interrupts masked.
+inline void SetPinModes(GPIO_TypeDef* gpio, uint32_t mask, uint32_t mode) noexcept
+{
+    const uint32_t primask = __get_PRIMASK();
+    __disable_irq();
+    gpio->MODER = (gpio->MODER & ~mask) | mode;
+    __set_PRIMASK(primask);
+}
+
+// Registers of the MCU's ports, the default Ports of IOPin and ParallelBus.
+struct HALPorts
+{
+    static GPIO_TypeDef* Regs(GPIOPort port) noexcept
+    {
+        switch (port)
+        {
+        case GPIOPort::A: return GPIOA;
+        case GPIOPort::B: return GPIOB;
+        case GPIOPort::C: return GPIOC;
+        case GPIOPort::Count: break;
+        }
+        __unreachable();
+    }
+
+    static void SetModes(GPIO_TypeDef* gpio, uint32_t mask, uint32_t mode) noexcept
+    {
+        SetPinModes(gpio, mask, mode);
+    }
+};
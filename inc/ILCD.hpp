@@ -47,6 +47,16 @@ enum class LCDAddress : uint8_t
     DDRAM = 7
 };
 
+// A single write on the LCD's bus, either an instruction or data.
+struct LCDBusWrite
+{
+    bool is_data;
+    uint8_t value;
+};
+
+// Most writes a single LCD sequence can hold, enough for every cell of a 16x2 display and an address per row.
+inline constexpr size_t lcd_max_sequence_writes = 96;
+
 template<typename T>
 class ILCD
 {
@@ -103,6 +113,10 @@ public:
     {
         return Impl().IsBusy(address_counter);
     }
+    [[nodiscard]] bool WriteSequence(std::span<const LCDBusWrite> writes, void (*on_complete)(void*), void* context) noexcept
+    {
+        return Impl().WriteSequence(writes, on_complete, context);
+    }
 
 private:
     T& Impl() noexcept
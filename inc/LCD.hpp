@@ -1,8 +1,25 @@
 #pragma once
 #include "ILCD.hpp"
+#include <algorithm>
+#include <array>
+#include <bitset>
 #include <cstdint>
+#include <optional>
 #include <span>
 
+enum class LCDVerifyPolicy : uint8_t
+{
+    None,
+    Sampled,    // Read back a few cells per flush, walking through the display over several flushes.
+    Full        // Read back every visible cell on every flush.
+};
+
+struct LCDVerifyStats
+{
+    uint32_t cells_checked;
+    uint32_t mismatches;
+};
+
 template<typename T>
 class LCD
 {
@@ -16,6 +33,7 @@ public:
     {
         m_ilcd.Init(init);
         m_init = init;
+        ResetShadow();
     }
 
     [[nodiscard]] LCDSettings GetSettings() const noexcept
@@ -32,16 +50,24 @@ public:
     void Clear() noexcept
     {
         m_ilcd.Clear();
+        ResetShadow();
     }
 
     void ReturnHome() noexcept
     {
         m_ilcd.ReturnHome();
+        m_cursor = 0;
+        m_display_shift = 0;
     }
 
     void SetAddress(LCDAddress type, uint8_t address) noexcept
     {
         m_ilcd.SetAddress(type, address);
+        m_cursor = std::nullopt;
+        if (type == LCDAddress::DDRAM)
+        {
+            m_cursor = CellIndexFromAddress(address);
+        }
     }
 
     [[nodiscard]] bool SetCursor(uint8_t row, uint8_t col) noexcept
@@ -53,6 +79,7 @@ public:
         }
 
         m_ilcd.SetCursor(row, col);
+        m_cursor = CellIndex(row, col);
         return true;
     }
 
@@ -61,29 +88,268 @@ public:
         m_ilcd.SetDisplayScroll(enable);
     }
 
+    // Shifts the display window by one column. This assumes automatic display shift on write is off.
     void SetDisplayScrollDirection(LCDScrollDirection dir) noexcept
     {
         m_ilcd.SetDisplayScrollDirection(dir);
+        const auto columns = GetCellsPerRow();
+        m_display_shift = (m_display_shift + (dir == LCDScrollDirection::Left ? 1 : columns - 1)) % columns;
     }
 
     [[nodiscard]] uint8_t Read() noexcept
     {
-        return m_ilcd.Read();
+        auto data = m_ilcd.Read();
+        AdvanceCursor(1);
+        return data;
     }
 
     [[nodiscard]] size_t Read(std::span<uint8_t> buffer) noexcept
     {
-        return m_ilcd.Read(buffer);
+        auto size = m_ilcd.Read(buffer);
+        AdvanceCursor(size);
+        return size;
     }
 
     void Write(uint8_t data) noexcept
     {
         m_ilcd.Write(data);
+        UpdateShadow({ &data, 1 });
     }
 
     [[nodiscard]] size_t Write(const std::span<uint8_t>& data) noexcept
     {
-        return m_ilcd.Write(data);
+        auto size = m_ilcd.Write(data);
+        UpdateShadow(data.subspan(0, size));
+        return size;
+    }
+
+    // Draws into the shadow copy of DDRAM. Nothing is sent to the LCD until Flush().
+    // The column is relative to the page being drawn, which is the back page in double buffered mode.
+    // Returns the number of cells drawn, which is clamped to the end of the row.
+    [[nodiscard]] size_t Draw(uint8_t row, uint8_t col, std::span<const uint8_t> data) noexcept
+    {
+        if (row >= GetRowCount() || col >= m_init.column_count)
+        {
+            return 0;
+        }
+
+        const auto offset = m_double_buffered ? GetBackPageShift() : m_display_shift;
+        auto size = std::min<size_t>(data.size(), m_init.column_count - col);
+        return DrawDDRAM(row, static_cast<uint8_t>((offset + col) % GetCellsPerRow()), data.subspan(0, size));
+    }
+
+    // Draws at a DDRAM column regardless of the display shift, wrapping around the end of the row.
+    // This can reach the columns that are not visible. Returns the number of cells drawn.
+    [[nodiscard]] size_t DrawDDRAM(uint8_t row, uint8_t ddram_col, std::span<const uint8_t> data) noexcept
+    {
+        const auto columns = GetCellsPerRow();
+        if (row >= GetRowCount() || ddram_col >= columns)
+        {
+            return 0;
+        }
+
+        auto size = std::min(data.size(), columns);
+        for (size_t i = 0; i < size; ++i)
+        {
+            auto index = CellIndex(row, (ddram_col + i) % columns);
+            if (m_shadow[index] != data[i])
+            {
+                m_shadow[index] = data[i];
+                m_dirty.set(index);
+            }
+        }
+        return size;
+    }
+
+    [[nodiscard]] size_t GetDDRAMColumns() const noexcept
+    {
+        return GetCellsPerRow();
+    }
+
+    // In double buffered mode Draw() renders into the DDRAM columns just right of the visible ones, and Flip()
+    // shows them. The controller has no display base address, so the two pages are shown by shifting the display:
+    // the back page is one column_count of display shifts away and the front page at 0 is one ReturnHome() away.
+    // Needs room for two pages in a DDRAM row, e.g. 16 of the 40 columns in two row mode.
+    [[nodiscard]] bool SetDoubleBuffered(bool enable) noexcept
+    {
+        if (enable && 2 * m_init.column_count > GetCellsPerRow())
+        {
+            return false;
+        }
+
+        m_double_buffered = enable;
+        return true;
+    }
+
+    // Sends the back page then shows it. Nothing on the back page is written while it is visible,
+    // so a frame is never seen half drawn.
+    void Flip() noexcept
+    {
+        if (!m_double_buffered)
+        {
+            Flush();
+            return;
+        }
+
+        SendDirtyCells();
+        const auto target = GetBackPageShift();
+        if (target == 0)
+        {
+            ReturnHome();
+            return;
+        }
+
+        while (m_display_shift != target)
+        {
+            SetDisplayScrollDirection(LCDScrollDirection::Left);
+        }
+    }
+
+    // Sends the cells that changed since the last flush, then checks the display according to the verify policy.
+    // Cells that read back wrong are sent again.
+    void Flush() noexcept
+    {
+        SendDirtyCells();
+        if (m_verify_policy != LCDVerifyPolicy::None && Verify())
+        {
+            SendDirtyCells();
+        }
+    }
+
+    // Sends the dirty cells as one DMA sequence and returns without waiting for it. Cells that don't fit in a
+    // sequence stay dirty for the next flush. Returns false if the previous sequence is still running.
+    // The verify policy is not applied since reading back would wait for the sequence.
+    [[nodiscard]] bool FlushAsync() noexcept
+    {
+        if (m_sequence_pending)
+        {
+            return false;
+        }
+
+        size_t count = 0;
+        std::bitset<cell_count> batch;
+        const auto cursor = m_cursor;
+        const auto row_count = GetRowCount();
+        const auto columns = GetCellsPerRow();
+        for (size_t row = 0; row < row_count && count < m_sequence.size(); ++row)
+        {
+            size_t col = 0;
+            while (col < columns && count < m_sequence.size())
+            {
+                auto index = CellIndex(row, col);
+                if (!m_dirty.test(index))
+                {
+                    ++col;
+                    continue;
+                }
+
+                if (m_cursor != index)
+                {
+                    if (count + 2 > m_sequence.size())
+                    {
+                        break;
+                    }
+                    const auto address = row * ddram_row_stride + col;
+                    m_sequence[count++] = { false, static_cast<uint8_t>((1u << static_cast<uint8_t>(LCDAddress::DDRAM)) | address) };
+                }
+
+                for (; col < columns && m_dirty.test(index) && count < m_sequence.size(); ++col, ++index)
+                {
+                    m_sequence[count++] = { true, m_shadow[index] };
+                    m_dirty.reset(index);
+                    batch.set(index);
+                }
+                m_cursor = index % cell_count;
+            }
+        }
+
+        if (count == 0)
+        {
+            return true;
+        }
+
+        m_sequence_pending = true;
+        if (!m_ilcd.WriteSequence({ m_sequence.data(), count }, &LCD::OnSequenceComplete, this))
+        {
+            // Nothing was sent, so the batch is dirty again and the address counter is where it was.
+            m_sequence_pending = false;
+            m_dirty |= batch;
+            m_cursor = cursor;
+            return false;
+        }
+        return true;
+    }
+
+    // Sends one command towards the dirty cells: the cell under the cursor if it is dirty, so runs don't need an
+    // address, or else the address of the first dirty cell. Returns false if there was nothing to send.
+    [[nodiscard]] bool SendNextDirtyCell() noexcept
+    {
+        if (!m_cursor || !m_dirty.test(*m_cursor))
+        {
+            const auto row_count = GetRowCount();
+            const auto columns = GetCellsPerRow();
+            std::optional<size_t> next;
+            for (size_t index = 0; index < row_count * columns && !next; ++index)
+            {
+                if (m_dirty.test(index))
+                {
+                    next = index;
+                }
+            }
+
+            if (!next)
+            {
+                return false;
+            }
+
+            // The address is a step of its own, so with deferred waits the data isn't held up by its execution time.
+            m_ilcd.SetCursor(static_cast<uint8_t>(*next / columns), static_cast<uint8_t>(*next % columns));
+            m_cursor = next;
+            return true;
+        }
+
+        const auto index = *m_cursor;
+        m_ilcd.Write(m_shadow[index]);
+        m_dirty.reset(index);
+        m_cursor = (index + 1) % cell_count;
+        return true;
+    }
+
+    [[nodiscard]] bool IsFlushPending() const noexcept
+    {
+        return m_sequence_pending;
+    }
+
+    // Applies the verify policy after FlushAsync(), once the sequence is done. Cells that read back wrong are marked
+    // dirty for the next flush. Returns true if there were any.
+    [[nodiscard]] bool CheckDisplay() noexcept
+    {
+        return !m_sequence_pending && m_verify_policy != LCDVerifyPolicy::None && Verify();
+    }
+
+    void SetVerifyPolicy(LCDVerifyPolicy policy, uint8_t sample_count = 4) noexcept
+    {
+        m_verify_policy = policy;
+        m_verify_sample_count = sample_count;
+    }
+
+    [[nodiscard]] LCDVerifyStats GetVerifyStats() const noexcept
+    {
+        return m_verify_stats;
+    }
+
+    // Number of cells in the shadow showing the given character. CGRAM codes 0x08 - 0x0F are aliases of 0x00 - 0x07.
+    [[nodiscard]] size_t CountCells(uint8_t code) const noexcept
+    {
+        return static_cast<size_t>(std::count_if(m_shadow.begin(), m_shadow.end(), [code](uint8_t cell)
+        {
+            return cell == code || (code < 0x10 && cell < 0x10 && (cell & 0x07) == (code & 0x07));
+        }));
+    }
+
+    [[nodiscard]] bool IsDirty() const noexcept
+    {
+        return m_dirty.any();
     }
 
     [[nodiscard]] bool IsBusy(uint8_t& address_counter) noexcept
@@ -92,9 +358,158 @@ public:
     }
 
 private:
+    // DDRAM is 80 bytes: 40 per row at 0x00 and 0x40 in two row mode, or 80 contiguous bytes in one row mode.
+    // Cells are indexed in the order the address counter walks through them, so the next cell is always index + 1.
+    static constexpr size_t cell_count = 80;
+    static constexpr uint8_t ddram_row_stride = 0x40;
+
     ILCD<T>& m_ilcd;
     LCDInit m_init;
     LCDSettings m_settings;
+    std::array<uint8_t, cell_count> m_shadow;
+    std::bitset<cell_count> m_dirty;
+    std::optional<size_t> m_cursor;     // Cell the DDRAM address counter points to, if known.
+    size_t m_display_shift = 0;         // DDRAM column shown in the leftmost visible column.
+    bool m_double_buffered = false;
+    LCDVerifyPolicy m_verify_policy = LCDVerifyPolicy::None;
+    uint8_t m_verify_sample_count = 0;
+    size_t m_verify_next = 0;           // Next visible cell to sample.
+    LCDVerifyStats m_verify_stats{};
+    std::array<LCDBusWrite, lcd_max_sequence_writes> m_sequence{};
+    volatile bool m_sequence_pending = false;
+
+    static void OnSequenceComplete(void* context) noexcept
+    {
+        static_cast<LCD*>(context)->m_sequence_pending = false;
+    }
+
+    // Neighbouring dirty cells are sent as one run so only the first cell of a run needs an address,
+    // which is skipped if the address counter is already there.
+    void SendDirtyCells() noexcept
+    {
+        const auto row_count = GetRowCount();
+        const auto columns = GetCellsPerRow();
+        for (size_t row = 0; row < row_count; ++row)
+        {
+            size_t col = 0;
+            while (col < columns)
+            {
+                auto index = CellIndex(row, col);
+                if (!m_dirty.test(index))
+                {
+                    ++col;
+                    continue;
+                }
+
+                if (m_cursor != index)
+                {
+                    m_ilcd.SetCursor(static_cast<uint8_t>(row), static_cast<uint8_t>(col));
+                }
+
+                for (; col < columns && m_dirty.test(index); ++col, ++index)
+                {
+                    m_ilcd.Write(m_shadow[index]);
+                    m_dirty.reset(index);
+                }
+                m_cursor = index % cell_count;
+            }
+        }
+    }
+
+    // Reads back visible cells and marks the ones that differ from the shadow as dirty.
+    // Returns true if any cell needs repairing.
+    [[nodiscard]] bool Verify() noexcept
+    {
+        const size_t visible_cells = GetRowCount() * m_init.column_count;
+        const size_t count = m_verify_policy == LCDVerifyPolicy::Full
+            ? visible_cells
+            : std::min<size_t>(m_verify_sample_count, visible_cells);
+
+        bool repair = false;
+        for (size_t i = 0; i < count; ++i)
+        {
+            const auto visible = (m_verify_next + i) % visible_cells;
+            const auto row = visible / m_init.column_count;
+            const auto col = (m_display_shift + visible % m_init.column_count) % GetCellsPerRow();
+            const auto index = CellIndex(row, col);
+            if (m_cursor != index)
+            {
+                m_ilcd.SetCursor(static_cast<uint8_t>(row), static_cast<uint8_t>(col));
+                m_cursor = index;
+            }
+
+            const auto data = m_ilcd.Read();
+            AdvanceCursor(1);
+            ++m_verify_stats.cells_checked;
+            if (data != m_shadow[index])
+            {
+                ++m_verify_stats.mismatches;
+                m_dirty.set(index);
+                repair = true;
+            }
+        }
+
+        m_verify_next = (m_verify_next + count) % visible_cells;
+        return repair;
+    }
+
+    [[nodiscard]] size_t GetCellsPerRow() const noexcept
+    {
+        return cell_count / GetRowCount();
+    }
+
+    [[nodiscard]] size_t CellIndex(size_t row, size_t col) const noexcept
+    {
+        return row * GetCellsPerRow() + col;
+    }
+
+    [[nodiscard]] size_t CellIndexFromAddress(uint8_t address) const noexcept
+    {
+        if (GetRowCount() == 1)
+        {
+            return address % cell_count;
+        }
+        return CellIndex(address / ddram_row_stride, address % ddram_row_stride) % cell_count;
+    }
+
+    // The page that is not visible. Pages start at DDRAM column 0 and column_count.
+    [[nodiscard]] size_t GetBackPageShift() const noexcept
+    {
+        return m_display_shift == 0 ? m_init.column_count : 0;
+    }
+
+    // Clear display also sets the address counter to 0 and undoes any display shift.
+    void ResetShadow() noexcept
+    {
+        m_shadow.fill(' ');
+        m_dirty.reset();
+        m_cursor = 0;
+        m_display_shift = 0;
+    }
+
+    void AdvanceCursor(size_t count) noexcept
+    {
+        if (m_cursor)
+        {
+            m_cursor = (*m_cursor + count) % cell_count;
+        }
+    }
+
+    // Keeps the shadow in sync with data written directly to DDRAM.
+    void UpdateShadow(std::span<const uint8_t> data) noexcept
+    {
+        if (!m_cursor)
+        {
+            return;
+        }
+
+        for (auto byte : data)
+        {
+            m_shadow[*m_cursor] = byte;
+            m_dirty.reset(*m_cursor);
+            AdvanceCursor(1);
+        }
+    }
 
     [[nodiscard]] size_t GetRowCount() const noexcept
     {
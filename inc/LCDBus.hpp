@@ -0,0 +1,79 @@
+#pragma once
+#include "ILCD.hpp"
+#include "LCDTiming.hpp"
+#include "Pins.hpp"
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <span>
+
+// The LCD's parallel bus, and the BSRR words that drive it. Everything here is constexpr so the
+// words can be precomputed, and expanded into DMA buffers without touching the hardware.
+
+using LCDDataBus = ParallelBus<lcd_data_pins>;
+#ifdef LCD_DATA_PINS_PC0_7
+static_assert(LCDDataBus::is_contiguous, "The respun pin map should use the single store path");
+#endif
+
+// BSRR words that put a byte on the data pins of each port.
+using BSRRWords = LCDDataBus::BSRRWords;
+inline constexpr auto& bsrr_table = LCDDataBus::bsrr_table;
+
+// One TIM1 update period. It has to cover the setup and pulse width times.
+inline constexpr uint32_t lcd_bus_slot_us = 14;
+// Nothing reads the busy flag during a sequence, so like write only mode it relies on the margin for a slow
+// oscillator. Data writes are the slowest command a sequence can hold.
+inline constexpr uint32_t lcd_bus_write_time_us = WithTimingMargin(lcd_data_write_time_us, LCD_TC1602A_TIMING_MARGIN_PERCENT);
+inline constexpr size_t lcd_bus_write_time_slots = (lcd_bus_write_time_us + lcd_bus_slot_us - 1) / lcd_bus_slot_us;
+
+// A write is RS and data, then E rising, then E falling, at which the LCD latches the data. It is followed by idle
+// slots so the next write's E doesn't rise until the execution time has passed.
+inline constexpr size_t lcd_bus_edge_slots = 3;
+inline constexpr size_t lcd_bus_slots_per_write = std::max(lcd_bus_edge_slots, lcd_bus_write_time_slots + 1);
+// After the last write, enough idle slots that it has executed by the time the DMA is done with the sequence.
+inline constexpr size_t lcd_bus_idle_slots = lcd_bus_write_time_slots + lcd_bus_edge_slots - lcd_bus_slots_per_write;
+static_assert((lcd_bus_slots_per_write - 1) * lcd_bus_slot_us >= lcd_bus_write_time_us, "E fall to the next E rise");
+static_assert((lcd_bus_slots_per_write - lcd_bus_edge_slots + lcd_bus_idle_slots) * lcd_bus_slot_us >= lcd_bus_write_time_us,
+    "E fall to the end of the sequence");
+
+[[nodiscard]] constexpr size_t LCDBusSlots(size_t write_count) noexcept
+{
+    return write_count * lcd_bus_slots_per_write + lcd_bus_idle_slots;
+}
+
+// Expands bus writes into BSRR words, with one array per port and one word per slot, including the idle slots at
+// the end. Returns the number of slots written, or 0 if they do not fit.
+constexpr size_t ExpandBusWrites(std::span<const LCDBusWrite> writes, const std::array<std::span<uint32_t>, gpio_port_count>& out,
+    const GPIOPin& e_pin = lcd_e_pin) noexcept
+{
+    const size_t slot_count = LCDBusSlots(writes.size());
+    for (const auto& port : out)
+    {
+        if (port.size() < slot_count)
+        {
+            return 0;
+        }
+    }
+
+    size_t slot = 0;
+    for (const auto& write : writes)
+    {
+        auto setup = bsrr_table[write.value];
+        setup[static_cast<size_t>(lcd_rs_pin.port)] |= MakePinWord(lcd_rs_pin, write.is_data);
+
+        for (size_t port = 0; port < gpio_port_count; ++port)
+        {
+            out[port][slot] = setup[port];
+            std::fill_n(out[port].begin() + slot + 1, lcd_bus_slots_per_write - 1, 0);
+        }
+        out[static_cast<size_t>(e_pin.port)][slot + 1] = MakePinWord(e_pin, true);
+        out[static_cast<size_t>(e_pin.port)][slot + 2] = MakePinWord(e_pin, false);
+        slot += lcd_bus_slots_per_write;
+    }
+
+    for (const auto& port : out)
+    {
+        std::fill_n(port.begin() + slot, lcd_bus_idle_slots, 0);
+    }
+    return slot_count;
+}
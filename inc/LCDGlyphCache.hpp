@@ -0,0 +1,133 @@
+#pragma once
+#include "LCD.hpp"
+#include <array>
+#include <cstdint>
+#include <optional>
+
+// 5x8 custom character. Only the lower 5 bits of each row are used.
+struct LCDGlyph
+{
+    std::array<uint8_t, 8> rows;
+};
+
+struct LCDGlyphCacheStats
+{
+    uint32_t hits;
+    uint32_t misses;
+    uint32_t evictions;
+    uint32_t failures;  // Misses where every slot was on screen.
+};
+
+// Maps any number of glyphs onto the 8 CGRAM slots. A glyph is only uploaded when it is not already in a slot,
+// and a slot is only reused if none of the cells in the LCD's shadow show it, so visible text is never changed.
+// Glyphs are identified by address, so they should have static storage.
+// Two row mode always uses 5x8 characters, which gives 8 slots of 8 bytes.
+template<typename T>
+class LCDGlyphCache
+{
+public:
+    static constexpr size_t slot_count = 8;
+
+    explicit LCDGlyphCache(LCD<T>& lcd) noexcept : m_lcd{ lcd }
+    {
+
+    }
+
+    // Returns the character code to draw the glyph with, or nothing if every slot is on screen.
+    [[nodiscard]] std::optional<uint8_t> Acquire(const LCDGlyph& glyph) noexcept
+    {
+        ++m_clock;
+        for (size_t slot = 0; slot < m_slots.size(); ++slot)
+        {
+            if (m_slots[slot].glyph == &glyph)
+            {
+                m_slots[slot].last_used = m_clock;
+                ++m_stats.hits;
+                return static_cast<uint8_t>(slot);
+            }
+        }
+
+        ++m_stats.misses;
+        auto slot = FindFreeSlot();
+        if (!slot)
+        {
+            ++m_stats.failures;
+            return std::nullopt;
+        }
+
+        Upload(*slot, glyph);
+        return static_cast<uint8_t>(*slot);
+    }
+
+    // Forgets every slot, e.g. after the LCD has been initialised again and CGRAM is undefined.
+    void Invalidate() noexcept
+    {
+        m_slots = {};
+    }
+
+    [[nodiscard]] LCDGlyphCacheStats GetStats() const noexcept
+    {
+        return m_stats;
+    }
+
+private:
+    struct Slot
+    {
+        const LCDGlyph* glyph;
+        uint32_t last_used;
+    };
+
+    LCD<T>& m_lcd;
+    std::array<Slot, slot_count> m_slots{};
+    uint32_t m_clock = 0;
+    LCDGlyphCacheStats m_stats{};
+
+    [[nodiscard]] std::optional<size_t> FindFreeSlot() noexcept
+    {
+        for (size_t slot = 0; slot < m_slots.size(); ++slot)
+        {
+            if (m_slots[slot].glyph == nullptr)
+            {
+                return slot;
+            }
+        }
+
+        // The shadow only matches the display once it has been flushed. Otherwise a cell that was just
+        // overwritten in the shadow could still be showing the slot that is about to be replaced.
+        if (m_lcd.IsDirty())
+        {
+            m_lcd.Flush();
+        }
+
+        std::optional<size_t> lru;
+        for (size_t slot = 0; slot < m_slots.size(); ++slot)
+        {
+            if (m_lcd.CountCells(static_cast<uint8_t>(slot)) != 0)
+            {
+                continue;
+            }
+
+            if (!lru || m_slots[slot].last_used < m_slots[*lru].last_used)
+            {
+                lru = slot;
+            }
+        }
+
+        if (lru)
+        {
+            ++m_stats.evictions;
+        }
+        return lru;
+    }
+
+    void Upload(size_t slot, const LCDGlyph& glyph) noexcept
+    {
+        m_lcd.SetAddress(LCDAddress::CGRAM, static_cast<uint8_t>(slot * glyph.rows.size()));
+        for (auto row : glyph.rows)
+        {
+            m_lcd.Write(static_cast<uint8_t>(row & 0x1F));
+        }
+
+        m_slots[slot] = { &glyph, m_clock };
+    }
+};
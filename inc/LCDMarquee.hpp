@@ -0,0 +1,93 @@
+#pragma once
+#include "LCD.hpp"
+#include <array>
+#include <cstdint>
+#include <span>
+
+// Scrolls text through the display using the controller's display shift, so each step is one instruction
+// instead of rewriting every visible cell.
+//
+// Each row's text is loaded into all of its DDRAM columns once (40 in two row mode). Text that fits is padded
+// with spaces and loops by itself. For longer text, each step also rewrites the one DDRAM column that just
+// scrolled out of view with the next character, which is the column furthest from coming back into view.
+//
+// The display shift moves every row at once, so the marquee owns the whole display while it runs.
+// Call Step() at the scroll rate, e.g. from a periodic job.
+template<typename T>
+class LCDMarquee
+{
+public:
+    static constexpr size_t max_rows = 2;
+
+    explicit LCDMarquee(LCD<T>& lcd) noexcept : m_lcd{ lcd }
+    {
+
+    }
+
+    // The text must outlive the marquee. An empty span clears the row.
+    void SetText(uint8_t row, std::span<const uint8_t> text) noexcept
+    {
+        if (row < m_text.size())
+        {
+            m_text[row] = text;
+        }
+    }
+
+    // Loads every row into DDRAM and moves the display back to the start of the text.
+    void Start() noexcept
+    {
+        m_position = 0;
+        m_lcd.ReturnHome();
+
+        const auto columns = m_lcd.GetDDRAMColumns();
+        for (size_t row = 0; row < m_text.size(); ++row)
+        {
+            for (size_t col = 0; col < columns; ++col)
+            {
+                const uint8_t data = GetCharacter(row, col);
+                static_cast<void>(m_lcd.DrawDDRAM(static_cast<uint8_t>(row), static_cast<uint8_t>(col), { &data, 1 }));
+            }
+        }
+        m_lcd.Flush();
+    }
+
+    // Scrolls the text one character to the left.
+    void Step() noexcept
+    {
+        m_lcd.SetDisplayScrollDirection(LCDScrollDirection::Left);
+        ++m_position;
+
+        // The column that just left the window is the last one to come back, where it will show
+        // the character one full DDRAM row ahead of the window.
+        const auto columns = m_lcd.GetDDRAMColumns();
+        const auto col = static_cast<uint8_t>((m_position + columns - 1) % columns);
+        for (size_t row = 0; row < m_text.size(); ++row)
+        {
+            if (m_text[row].size() <= columns)
+            {
+                continue;
+            }
+
+            const uint8_t data = GetCharacter(row, m_position + columns - 1);
+            static_cast<void>(m_lcd.DrawDDRAM(static_cast<uint8_t>(row), col, { &data, 1 }));
+        }
+        m_lcd.Flush();
+    }
+
+private:
+    LCD<T>& m_lcd;
+    std::array<std::span<const uint8_t>, max_rows> m_text{};
+    size_t m_position = 0;  // Index into the text shown in the leftmost visible column.
+
+    [[nodiscard]] uint8_t GetCharacter(size_t row, size_t index) const noexcept
+    {
+        const auto& text = m_text[row];
+        const auto columns = m_lcd.GetDDRAMColumns();
+        if (text.size() <= columns)
+        {
+            index %= columns;
+            return index < text.size() ? text[index] : ' ';
+        }
+        return text[index % text.size()];
+    }
+};
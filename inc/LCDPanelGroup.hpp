@@ -0,0 +1,80 @@
+#pragma once
+#include "LCD.hpp"
+#include <array>
+#include <cstdint>
+
+// Drives several panels that share one data bus and differ only in their E pin. Each panel keeps its own
+// LCD<T> and shadow state.
+//
+// The panels' drivers should use deferred waits, so a command returns as soon as it is on the bus. Commands are
+// then interleaved one per panel, a cell's address and its data being separate commands, and a panel that is still
+// executing, e.g. a clear, is skipped until its busy flag clears. With N panels, each one's execution time overlaps
+// the commands to the others. One panel may be in async mode, in which case its interrupt waits for the commands
+// sent from here to be off the bus.
+template<typename T, size_t N>
+class LCDPanelGroup
+{
+public:
+    explicit LCDPanelGroup(const std::array<LCD<T>*, N>& panels) noexcept : m_panels{ panels }
+    {
+
+    }
+
+    [[nodiscard]] LCD<T>& operator[](size_t index) noexcept
+    {
+        return *m_panels[index];
+    }
+
+    [[nodiscard]] static constexpr size_t size() noexcept
+    {
+        return N;
+    }
+
+    // Every panel clears at the same time.
+    void Clear() noexcept
+    {
+        for (auto* panel : m_panels)
+        {
+            panel->Clear();
+        }
+    }
+
+    // Sends every panel's dirty cells, round robin between the panels that are ready.
+    void Flush() noexcept
+    {
+        bool any_dirty = true;
+        while (any_dirty)
+        {
+            any_dirty = false;
+            for (auto* panel : m_panels)
+            {
+                if (!panel->IsDirty())
+                {
+                    continue;
+                }
+
+                any_dirty = true;
+                uint8_t address_counter = 0;
+                if (!panel->IsBusy(address_counter))
+                {
+                    static_cast<void>(panel->SendNextDirtyCell());
+                }
+            }
+        }
+    }
+
+    [[nodiscard]] bool IsDirty() const noexcept
+    {
+        for (const auto* panel : m_panels)
+        {
+            if (panel->IsDirty())
+            {
+                return true;
+            }
+        }
+        return false;
+    }
+
+private:
+    std::array<LCD<T>*, N> m_panels;
+};
@@ -0,0 +1,62 @@
+#pragma once
+#include <array>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+
+// Execution times of the HD44780's commands, and which time an instruction takes. Nothing here touches the
+// hardware.
+
+#ifndef LCD_TC1602A_TIMING_MARGIN_PERCENT
+#define LCD_TC1602A_TIMING_MARGIN_PERCENT 25
+#endif
+
+// Commands grouped by execution time. Instructions are in the order of their highest set bit.
+enum class LCDCommandClass : uint8_t
+{
+    ClearDisplay,
+    ReturnHome,
+    EntryMode,
+    DisplayControl,
+    CursorDisplayShift,
+    Function,
+    CGRAMAddress,
+    DDRAMAddress,
+    DataWrite,
+    DataRead
+};
+inline constexpr size_t lcd_command_class_count = 10;
+
+// Data writes take 37 us plus 4 us for the address counter update (tADD) at fosc = 270 kHz. Reads take as long.
+inline constexpr uint32_t lcd_data_write_time_us = 41;
+
+// Class of a write. Every instruction is identified by its highest set bit.
+[[nodiscard]] constexpr LCDCommandClass LCDCommandClassOf(bool is_data, uint8_t value) noexcept
+{
+    if (is_data)
+    {
+        return LCDCommandClass::DataWrite;
+    }
+
+    const auto highest_bit = std::bit_width(value);
+    return static_cast<LCDCommandClass>(highest_bit > 0 ? highest_bit - 1 : 0);
+}
+
+// Rounded up, so a margin never shortens a wait.
+[[nodiscard]] constexpr uint32_t WithTimingMargin(uint32_t time_us, uint32_t margin_percent) noexcept
+{
+    return (time_us * (100 + margin_percent) + 99) / 100;
+}
+
+// Execution times at fosc = 270 kHz plus the margin, indexed by LCDCommandClass.
+[[nodiscard]] constexpr std::array<uint16_t, lcd_command_class_count> LCDExecutionTimes(uint32_t margin_percent) noexcept
+{
+    constexpr auto data = static_cast<uint16_t>(lcd_data_write_time_us);
+    constexpr std::array<uint16_t, lcd_command_class_count> nominal_us{ 1520, 1520, 37, 37, 37, 37, 37, 37, data, data };
+    std::array<uint16_t, lcd_command_class_count> times{};
+    for (size_t i = 0; i < times.size(); ++i)
+    {
+        times[i] = static_cast<uint16_t>(WithTimingMargin(nominal_us[i], margin_percent));
+    }
+    return times;
+}
@@ -1,5 +1,8 @@
 #pragma once
 #include "LCD.hpp"
+#include "LCDBus.hpp"
+#include <array>
+#include <atomic>
 #include <bitset>
 
 class LCD_TC1602A : public ILCD<LCD_TC1602A>
@@ -7,6 +10,27 @@ class LCD_TC1602A : public ILCD<LCD_TC1602A>
 public:
     using data_t = std::bitset<8>;
 
+    using CommandClass = LCDCommandClass;
+    static constexpr size_t command_class_count = lcd_command_class_count;
+
+    // Measured time from the end of a command until the busy flag clears.
+    struct LatencyStats
+    {
+        uint32_t average_us;
+        uint32_t max_us;
+        uint32_t samples;
+    };
+
+    struct BusStats
+    {
+        uint32_t direction_switches;
+        uint32_t direction_switches_avoided;
+    };
+
+    // Panels can share the data bus, RS and RW, and differ only in their E pin.
+    LCD_TC1602A() noexcept = default;
+    explicit LCD_TC1602A(GPIOPin e_pin) noexcept : m_e_pin{ e_pin } {}
+
     void Init(const LCDInit& init) noexcept;
     void SetSettings(const LCDSettings& settings) noexcept;
     void Clear() noexcept;
@@ -21,6 +45,50 @@ public:
     [[nodiscard]] size_t Write(const std::span<uint8_t>& data) noexcept;
     [[nodiscard]] bool IsBusy(uint8_t& address_counter) noexcept;
 
+    [[nodiscard]] static BusStats GetBusStats() noexcept;
+    [[nodiscard]] LatencyStats GetLatencyStats(CommandClass command_class) const noexcept;
+
+    // The address counter is tracked in software from the commands sent, so it never needs to be read back.
+    [[nodiscard]] uint8_t GetAddressCounter() const noexcept
+    {
+        return m_address;
+    }
+    // Compares the tracked address counter with the LCD's and resyncs it on a mismatch.
+    [[nodiscard]] bool VerifyAddressCounter() noexcept;
+    [[nodiscard]] uint32_t GetAddressMismatches() const noexcept
+    {
+        return m_address_mismatches;
+    }
+
+    // In async mode, commands and data are queued and sent from the TIM6 interrupt, which waits for each
+    // command's execution time. Reads and IsBusy() wait for the queue to drain first.
+    void SetAsync(bool enable) noexcept;
+    // Returns a frame ID covering everything queued so far.
+    [[nodiscard]] uint32_t MarkFrame() const noexcept;
+    [[nodiscard]] bool IsFrameComplete(uint32_t frame) const noexcept;
+    void WaitForFrame(uint32_t frame) noexcept;
+    [[nodiscard]] bool IsIdle() const noexcept;
+    void WaitUntilIdle() noexcept;
+    // Call from the TIM6 update interrupt. Only one panel on the bus can be in async mode. If the interrupt finds
+    // another panel's command or a sequence on the bus, it tries again shortly.
+    void OnTimerElapsed() noexcept;
+
+    // With deferred waits, a command returns as soon as it is on the bus and the next command to this panel waits
+    // for it instead. Other panels on the bus can be driven meanwhile, and IsBusy() reports when this one is done.
+    // Has no effect in write only mode since the busy flag can't be read.
+    void SetDeferredWait(bool enable) noexcept;
+
+    // Sends the writes with TIM1 and DMA writing the bus, so the CPU is free until on_complete is called from the
+    // DMA interrupt. Returns false if a sequence is already running, there are too many writes, or a write is
+    // clear display or return home which take longer than a slot.
+    [[nodiscard]] bool WriteSequence(std::span<const LCDBusWrite> writes, void (*on_complete)(void*), void* context) noexcept;
+    [[nodiscard]] bool IsSequenceRunning() const noexcept
+    {
+        return m_sequence_running;
+    }
+    // Call from the DMA transfer complete interrupt of port B.
+    void OnSequenceComplete() noexcept;
+
 private:
     enum class IOMode : uint8_t
     {
@@ -50,7 +118,51 @@ private:
         Function
     };
 
-    bool WaitUntilReady(uint32_t timeout_ms) noexcept;
+    struct QueuedCommand
+    {
+        RegisterSelect rs;
+        uint8_t data;
+        CommandClass command_class;
+    };
+
+    struct LatencyEstimate
+    {
+        uint32_t average_16ths;
+        uint32_t max_us;
+        uint32_t samples;
+    };
+
+    GPIOPin m_e_pin = lcd_e_pin;
+    std::array<LatencyEstimate, command_class_count> m_latency{};
+
+    LCDAddress m_address_type = LCDAddress::DDRAM;
+    uint8_t m_address = 0;
+    bool m_increment = true;
+    bool m_two_rows = true;
+    uint32_t m_address_mismatches = 0;
+
+    std::array<QueuedCommand, 64> m_queue{};
+    std::atomic<uint32_t> m_queue_head{ 0 };    // Total commands queued. Only written by the main loop.
+    std::atomic<uint32_t> m_queue_tail{ 0 };    // Total commands completed. Only written by the interrupt.
+    volatile bool m_queue_running = false;
+    bool m_command_in_flight = false;
+    uint32_t m_in_flight_elapsed_us = 0;
+    bool m_async = false;
+
+    bool m_deferred_wait = false;
+    bool m_command_pending = false;     // A deferred command may still be executing.
+    CommandClass m_pending_class = CommandClass::DataWrite;
+    uint32_t m_pending_start_us = 0;    // Timer_us() when the pending command was sent.
+
+    volatile bool m_sequence_running = false;
+    void (*m_sequence_on_complete)(void*) = nullptr;
+    void* m_sequence_context = nullptr;
+
+    [[nodiscard]] bool ReadStatus(uint8_t& address_counter) noexcept;
+    bool WaitUntilReady(CommandClass command_class, uint32_t timeout_ms) noexcept;
+    // Time after a command at which to start polling the busy flag, or to assume it is done in write only mode.
+    [[nodiscard]] uint32_t GetPollStart(CommandClass command_class) const noexcept;
+    void RecordLatency(CommandClass command_class, uint32_t latency_us) noexcept;
     void SetEntryMode(TextDirection dir, bool enableDisplayScroll) noexcept;
 
     void SetupDataPins(IOMode mode) noexcept;
@@ -65,6 +177,12 @@ private:
     void SetupCommand(RegisterSelect rs, IOMode mode) noexcept;
     void SendWriteCommand(RegisterSelect rs, data_t data) noexcept;
     void SendWriteCommandAndWait(RegisterSelect rs, data_t data) noexcept;
+    void WaitForSequence() const noexcept;
+    void WaitForPendingCommand() noexcept;
+    void Enqueue(RegisterSelect rs, data_t data) noexcept;
+    [[nodiscard]] static CommandClass GetCommandClass(RegisterSelect rs, data_t data) noexcept;
+    void TrackAddress(RegisterSelect rs, data_t data) noexcept;
+    void AdvanceAddress() noexcept;
     [[nodiscard]] data_t SendReadCommand(RegisterSelect rs) noexcept;
 
     friend class AutoEnable;
@@ -0,0 +1,32 @@
+#pragma once
+#include "GPIOPin.hpp"
+#include "stm32l4xx_hal.h"
+#include <bit>
+#include <cstdint>
+
+enum class PinEdge : uint8_t
+{
+    Rising,
+    Falling,
+    Both
+};
+
+// Catches an edge on a pin through its EXTI line, so a wait on the pin can sleep instead of polling it.
+//
+// A line serves pin n of one port at a time, whichever was armed last. Only lines 5 - 9 are served, through
+// EXTI9_5_IRQHandler, which dispatches all five to OnPinEdgeInterrupt. Pins on other lines are never armed, so
+// check them with IsPinEdgeLine where they are chosen.
+inline constexpr uint16_t pin_edge_lines = GPIO_PIN_5 | GPIO_PIN_6 | GPIO_PIN_7 | GPIO_PIN_8 | GPIO_PIN_9;
+
+[[nodiscard]] constexpr bool IsPinEdgeLine(const GPIOPin& pin) noexcept
+{
+    return std::has_single_bit(pin.pin) && (pin.pin & pin_edge_lines) != 0;
+}
+
+void ArmPinEdge(const GPIOPin& pin, PinEdge edge) noexcept;
+void DisarmPinEdge(const GPIOPin& pin) noexcept;
+// True once the armed edge has happened, after which the line is disarmed.
+[[nodiscard]] bool HasPinEdge(const GPIOPin& pin) noexcept;
+
+// Call from HAL_GPIO_EXTI_Callback.
+void OnPinEdgeInterrupt(uint16_t pin) noexcept;
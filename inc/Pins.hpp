@@ -1,34 +1,82 @@
 #pragma once
-#define BTN_Pin GPIO_PIN_13
-#define BTN_GPIO_Port GPIOC
-#define LED_Pin GPIO_PIN_5
-#define LED_GPIO_Port GPIOA
-// LCD register select pin (D2)
-#define LCD_RS_Pin GPIO_PIN_10
-#define LCD_RS_GPIO_Port GPIOA
-// LCD read/write pin (D3)
-#define LCD_RW_Pin GPIO_PIN_3
-#define LCD_RW_GPIO_Port GPIOB
-// LCD enable pin (D4)
-#define LCD_E_Pin GPIO_PIN_5
-#define LCD_E_GPIO_Port GPIOB
+#include "GPIOPin.hpp"
+#include <span>
+
+// Every pin the firmware uses. MX_GPIO_Init configures them from these, so a pin only has to change here.
+inline constexpr GPIOPin btn_pin{ GPIOPort::C, 1u << 13 };
+inline constexpr GPIOPin led_pin{ GPIOPort::A, 1u << 5 };
+// LCD register select, read/write and enable (D2 - D4)
+inline constexpr GPIOPin lcd_rs_pin{ GPIOPort::A, 1u << 10 };
+inline constexpr GPIOPin lcd_rw_pin{ GPIOPort::B, 1u << 3 };
+inline constexpr GPIOPin lcd_e_pin{ GPIOPort::B, 1u << 5 };
+#ifdef LCD_DATA_PINS_PC0_7
+// LCD data pins on respun boards, all on one port so a byte is a single store.
+inline constexpr std::array<GPIOPin, 8> lcd_data_pins
+{ {
+    { GPIOPort::C, 1u << 0 },
+    { GPIOPort::C, 1u << 1 },
+    { GPIOPort::C, 1u << 2 },
+    { GPIOPort::C, 1u << 3 },
+    { GPIOPort::C, 1u << 4 },
+    { GPIOPort::C, 1u << 5 },
+    { GPIOPort::C, 1u << 6 },
+    { GPIOPort::C, 1u << 7 }
+} };
+#else
 // LCD data pins (D5 - D12)
-#define LCD_D0_Pin GPIO_PIN_4
-#define LCD_D0_GPIO_Port GPIOB
-#define LCD_D1_Pin GPIO_PIN_10
-#define LCD_D1_GPIO_Port GPIOB
-#define LCD_D2_Pin GPIO_PIN_8
-#define LCD_D2_GPIO_Port GPIOA
-#define LCD_D3_Pin GPIO_PIN_9
-#define LCD_D3_GPIO_Port GPIOA
-#define LCD_D4_Pin GPIO_PIN_7
-#define LCD_D4_GPIO_Port GPIOC
-#define LCD_D5_Pin GPIO_PIN_6
-#define LCD_D5_GPIO_Port GPIOB
-#define LCD_D6_Pin GPIO_PIN_7
-#define LCD_D6_GPIO_Port GPIOA
-#define LCD_D7_Pin GPIO_PIN_6
-#define LCD_D7_GPIO_Port GPIOA
-// Temperature sensor data pin
-#define TEMP_DATA_Pin GPIO_PIN_8
-#define TEMP_DATA_GPIO_Port GPIOB
\ No newline at end of file
+inline constexpr std::array<GPIOPin, 8> lcd_data_pins
+{ {
+    { GPIOPort::B, 1u << 4 },
+    { GPIOPort::B, 1u << 10 },
+    { GPIOPort::A, 1u << 8 },
+    { GPIOPort::A, 1u << 9 },
+    { GPIOPort::C, 1u << 7 },
+    { GPIOPort::B, 1u << 6 },
+    { GPIOPort::A, 1u << 7 },
+    { GPIOPort::A, 1u << 6 }
+} };
+#endif
+// Temperature sensor data pin, TIM16_CH1 in its alternate function.
+inline constexpr GPIOPin temp_data_pin{ GPIOPort::B, 1u << 8 };
+// Extra temperature sensors read together by sampling the port (RHT03_ARRAY). They go through one IDR, so they
+// have to share a port.
+inline constexpr std::array<GPIOPin, 4> rht03_array_pins
+{ {
+    { GPIOPort::C, 1u << 8 },
+    { GPIOPort::C, 1u << 9 },
+    { GPIOPort::C, 1u << 10 },
+    { GPIOPort::C, 1u << 11 }
+} };
+
+// True if no two of the pins share a line and each is a single line.
+[[nodiscard]] constexpr bool ArePinsDistinct(std::span<const GPIOPin> pins) noexcept
+{
+    std::array<uint16_t, gpio_port_count> used{};
+    for (const auto& pin : pins)
+    {
+        auto& port = used[static_cast<size_t>(pin.port)];
+        if (std::popcount(pin.pin) != 1 || (port & pin.pin) != 0)
+        {
+            return false;
+        }
+        port |= pin.pin;
+    }
+    return true;
+}
+
+static_assert([]()
+{
+    std::array<GPIOPin, 6 + lcd_data_pins.size() + rht03_array_pins.size()> pins{ btn_pin, led_pin, lcd_rs_pin, lcd_rw_pin, lcd_e_pin, temp_data_pin };
+    size_t count = 6;
+    for (const auto& pin : lcd_data_pins)
+    {
+        pins[count++] = pin;
+    }
+#ifdef RHT03_ARRAY
+    for (const auto& pin : rht03_array_pins)
+    {
+        pins[count++] = pin;
+    }
+#endif
+    return ArePinsDistinct(std::span<const GPIOPin>(pins).first(count));
+}(), "A line is used twice");
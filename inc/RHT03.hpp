@@ -0,0 +1,100 @@
+#pragma once
+#include "RHT03Decoder.hpp"
+#include "SteadyClock.hpp"
+#include <array>
+#include <chrono>
+#include <cstdint>
+
+enum class RHT03State : uint8_t
+{
+    Idle,
+    StartPulse,     // The host holds the line low.
+    Release,        // The host has let go and waits for the sensor.
+    Acknowledge,    // The sensor holds the line low, then high.
+    Data,
+    Decode
+};
+
+[[nodiscard]] constexpr const char* ToString(RHT03State state) noexcept
+{
+    switch (state)
+    {
+    case RHT03State::Idle: return "idle";
+    case RHT03State::StartPulse: return "start pulse";
+    case RHT03State::Release: return "release";
+    case RHT03State::Acknowledge: return "acknowledge";
+    case RHT03State::Data: return "data";
+    case RHT03State::Decode: return "decode";
+    }
+    return "unknown";
+}
+
+// When each state of a read was entered, in us from the start of the start pulse. 0 for states it didn't reach.
+// The times after StartPulse come from the captured edges, so they are the line's, not the CPU's.
+struct RHT03Timeline
+{
+    SteadyClock::time_point start;
+    uint16_t release_us;
+    uint16_t acknowledge_us;
+    uint16_t data_us;
+    uint16_t end_us;        // The sensor let go of the line after the last bit.
+    uint16_t decode_us;
+    RHT03State last_state;  // Furthest state the read got to.
+};
+
+// RHT03 on TEMP_DATA, read through TIM16 channel 1. The timer captures both edges at 1 us and DMA stores every
+// timestamp, so nothing has to run during the frame and an interrupt can't shift a bit. The DMA transfer complete
+// interrupt decodes the frame with DecodeRHT03.
+//
+// A read is a state machine driven by TIM16's interrupts, so StartRead() returns at once:
+//  - StartPulse: TEMP_DATA is an open drain output held low. TIM16 only has the capture channel, so its update
+//    event ends the pulse: the counter starts start_pulse before it wraps.
+//  - Release: the update interrupt starts the capture and releases the line, which is always the first edge.
+//  - Acknowledge and Data follow from how many edges the DMA has stored, without an interrupt per edge.
+//  - Decode: the transfer complete interrupt decodes the frame and goes back to Idle.
+class RHT03
+{
+public:
+    // The host releasing the line, then the frame.
+    static constexpr size_t capture_edges = rht03_frame_edges + 1;
+    // Datasheet asks for at least 1 ms. Longer wakes up sensors on long cables more reliably.
+    static constexpr std::chrono::milliseconds start_pulse{ 10 };
+    static_assert(start_pulse < std::chrono::microseconds{ 0x10000 }, "Timed by one wrap of the 16 bit counter");
+    // Acknowledge and 40 bits of 1s take about 5 ms. A wait for it in scheduler ticks can be up to 1 ms short.
+    static constexpr std::chrono::milliseconds frame_time{ 7 };
+    // From StartRead() until a read that is still going never will complete.
+    static constexpr std::chrono::milliseconds read_time = start_pulse + frame_time;
+
+    // Fails if a read is already running or something holds the line low.
+    [[nodiscard]] bool StartRead() noexcept;
+    [[nodiscard]] RHT03State GetState() const noexcept;
+    [[nodiscard]] bool IsReading() const noexcept
+    {
+        return m_state != RHT03State::Idle;
+    }
+    // Stops a read that didn't complete, e.g. because the sensor didn't answer.
+    void CancelRead() noexcept;
+    // Result and timeline of the last completed or cancelled read.
+    [[nodiscard]] RHT03Result GetResult() const noexcept
+    {
+        return m_result;
+    }
+    [[nodiscard]] RHT03Timeline GetTimeline() const noexcept
+    {
+        return m_timeline;
+    }
+
+    // Call from HAL_TIM_PeriodElapsedCallback for TIM16.
+    void OnStartPulseElapsed() noexcept;
+    // Call from HAL_TIM_IC_CaptureCallback for TIM16.
+    void OnCaptureComplete() noexcept;
+
+private:
+    std::array<uint16_t, capture_edges> m_edges{};
+    RHT03Result m_result{ RHT03Status::MissingEdges, {} };
+    RHT03Timeline m_timeline{};
+    volatile RHT03State m_state = RHT03State::Idle;
+
+    [[nodiscard]] size_t CapturedEdges() const noexcept;
+    void RecordTimeline(size_t edges) noexcept;
+};
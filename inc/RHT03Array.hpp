@@ -0,0 +1,73 @@
+#pragma once
+#include "GPIOPin.hpp"
+#include "RHT03.hpp"
+#include "RHT03SampleDecoder.hpp"
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <span>
+
+// RHT03s on several pins of one port, read together. Every line is pulled low and released by one BSRR store, and
+// while the sensors answer, TIM15's update event has DMA1 channel 5 copy the port's IDR into a buffer every us.
+// Nothing runs per edge or per sensor during the frame, so reading any number of sensors takes as long as one.
+//
+// The lines are open drain outputs with pull-ups, so releasing one is setting its output and IDR reads the line.
+// A read is driven by the caller, e.g. a task:
+//  - BeginRead() starts the start pulse.
+//  - Release() start_pulse later starts sampling and releases every line.
+//  - Sampling stops by itself after sample_time, when DMA has filled the buffer.
+//  - Decode() goes through the samples once for every sensor. It takes a few hundred us, so it isn't done in the
+//    interrupt.
+class RHT03Array
+{
+public:
+    static constexpr size_t max_sensors = 4;
+    static constexpr std::chrono::milliseconds start_pulse = RHT03::start_pulse;
+    static constexpr std::chrono::microseconds sample_time{ rht03_port_samples };
+
+    // The pins have to share a port. Any past max_sensors are ignored.
+    explicit RHT03Array(std::span<const GPIOPin> pins) noexcept;
+
+    [[nodiscard]] size_t Size() const noexcept
+    {
+        return m_size;
+    }
+
+    // Fails if a read is already running or something holds a line low.
+    [[nodiscard]] bool BeginRead() noexcept;
+    void Release() noexcept;
+    [[nodiscard]] bool IsReading() const noexcept
+    {
+        return m_is_pulsing || m_is_sampling;
+    }
+    [[nodiscard]] bool IsSampling() const noexcept
+    {
+        return m_is_sampling;
+    }
+    // Stops a read and releases the lines. Its results are MissingEdges.
+    void CancelRead() noexcept;
+
+    // Decodes every sensor's frame once sampling is complete. Does nothing until then, or if the read was cancelled.
+    void Decode() noexcept;
+    // Result of the last decode, in the order of the pins.
+    [[nodiscard]] RHT03Result GetResult(size_t sensor) const noexcept
+    {
+        return m_results[sensor];
+    }
+
+    // Call from the DMA transfer complete callback of TIM15's update.
+    void OnSamplingComplete() noexcept;
+
+private:
+    GPIOPort m_port;
+    uint16_t m_lines = 0;                       // Every sensor's pin.
+    std::array<uint16_t, max_sensors> m_pins{}; // Unused ones are 0 and never change.
+    size_t m_size = 0;
+    std::array<uint16_t, rht03_port_samples> m_samples{};
+    std::array<RHT03Result, max_sensors> m_results{};
+    volatile bool m_is_pulsing = false;
+    volatile bool m_is_sampling = false;
+    volatile bool m_has_samples = false;        // Sampling completed and hasn't been decoded yet.
+
+    void StopSampling() noexcept;
+};
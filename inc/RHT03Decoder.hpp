@@ -0,0 +1,218 @@
+#pragma once
+#include "FixedPoint.hpp"
+#include <array>
+#include <cstdint>
+#include <span>
+
+// Decoding of an RHT03 frame from the time of every edge on its data line. Nothing here touches the hardware, so
+// it runs the same on the host and at compile time.
+//
+// After the host's start pulse, the sensor acknowledges with 80 us low and 80 us high, then sends 40 bits MSB
+// first, each 50 us low followed by 26 - 28 us high for a 0 or 70 us high for a 1. It ends with 50 us low and
+// releases the line. The bytes are humidity, temperature and a checksum, the low byte of the sum of the others.
+
+inline constexpr size_t rht03_frame_bytes = 5;
+inline constexpr size_t rht03_frame_bits = rht03_frame_bytes * 8;
+// Acknowledge low and high, both edges of every bit, then the end low and the release.
+inline constexpr size_t rht03_frame_edges = 2 + 2 * rht03_frame_bits + 2;
+
+// Bounds in us, wide enough for cable capacitance and the sensor's own clock error.
+inline constexpr uint16_t rht03_min_ack_us = 40;
+inline constexpr uint16_t rht03_max_ack_us = 120;
+inline constexpr uint16_t rht03_min_bit_low_us = 20;
+inline constexpr uint16_t rht03_max_bit_low_us = 90;
+inline constexpr uint16_t rht03_min_bit_high_us = 10;
+inline constexpr uint16_t rht03_max_bit_high_us = 100;
+// A high longer than this is a 1, for the fixed classifier.
+inline constexpr uint16_t rht03_one_threshold_us = 50;
+// Highs closer than this are taken to be all the same bit, so there are no two clusters to split.
+inline constexpr uint16_t rht03_min_cluster_separation_us = 15;
+
+// How the highs are told apart. A 0's high is about half of the 50 us low before it and a 1's is about one and a
+// half, so the measured low scales with the sensor's clock and is a threshold by itself. The split also follows
+// the highs being stretched or squashed relative to the lows, e.g. by a slow rising edge on a long cable.
+enum class RHT03BitClassifier : uint8_t
+{
+    FixedThreshold,     // rht03_one_threshold_us.
+    LowRatio,           // The frame's average low.
+    TwoCluster          // Split between the averages of the short and long highs, or LowRatio if all are alike.
+};
+
+enum class RHT03Status : uint8_t
+{
+    Ok,
+    MissingEdges,
+    BadAcknowledge,
+    BadBit,
+    ChecksumMismatch,
+    LineBusy            // From the driver rather than the decoder: the line wasn't idle high at the start.
+};
+
+[[nodiscard]] constexpr const char* ToString(RHT03Status status) noexcept
+{
+    switch (status)
+    {
+    case RHT03Status::Ok: return "ok";
+    case RHT03Status::MissingEdges: return "missing edges";
+    case RHT03Status::BadAcknowledge: return "bad acknowledge";
+    case RHT03Status::BadBit: return "bad bit timing";
+    case RHT03Status::ChecksumMismatch: return "checksum mismatch";
+    case RHT03Status::LineBusy: return "line busy";
+    }
+    return "unknown";
+}
+
+struct RHT03Reading
+{
+    Tenths humidity;
+    Tenths temp;
+};
+
+struct RHT03Result
+{
+    RHT03Status status;
+    RHT03Reading reading;
+    uint16_t threshold_us = 0;  // Highs longer than this were 1s.
+    uint16_t margin_us = 0;     // Closest any high came to the threshold. Small margins come before bit errors.
+};
+
+// Threshold between a 0's high and a 1's. Highs is every bit's high and lows_sum is the sum of every bit's low.
+[[nodiscard]] constexpr uint16_t RHT03BitThreshold(const std::array<uint16_t, rht03_frame_bits>& highs, uint32_t lows_sum,
+    RHT03BitClassifier classifier) noexcept
+{
+    if (classifier == RHT03BitClassifier::FixedThreshold)
+    {
+        return rht03_one_threshold_us;
+    }
+
+    const auto low_ratio = static_cast<uint16_t>((lows_sum + rht03_frame_bits / 2) / rht03_frame_bits);
+    uint16_t min = highs[0];
+    uint16_t max = highs[0];
+    for (auto high : highs)
+    {
+        min = high < min ? high : min;
+        max = high > max ? high : max;
+    }
+    if (classifier == RHT03BitClassifier::LowRatio || max - min < rht03_min_cluster_separation_us)
+    {
+        return low_ratio;
+    }
+
+    // Two means in one dimension, starting from the middle of the range. It settles in a few passes.
+    uint16_t threshold = static_cast<uint16_t>((min + max) / 2);
+    for (int pass = 0; pass < 8; ++pass)
+    {
+        uint32_t sums[2]{};
+        uint32_t counts[2]{};
+        for (auto high : highs)
+        {
+            const size_t cluster = high > threshold ? 1 : 0;
+            sums[cluster] += high;
+            ++counts[cluster];
+        }
+
+        const auto next = static_cast<uint16_t>((sums[0] * counts[1] + sums[1] * counts[0]) / (2 * counts[0] * counts[1]));
+        if (next == threshold)
+        {
+            break;
+        }
+        threshold = next;
+    }
+    return threshold;
+}
+
+// Timestamps are in us from a 16 bit counter, which may wrap during the frame. The frame is the last
+// rht03_frame_edges of them and its first edge is falling, so edges before it, e.g. the host releasing the line,
+// are ignored.
+[[nodiscard]] constexpr RHT03Result DecodeRHT03(std::span<const uint16_t> edges,
+    RHT03BitClassifier classifier = RHT03BitClassifier::TwoCluster) noexcept
+{
+    if (edges.size() < rht03_frame_edges)
+    {
+        return { RHT03Status::MissingEdges, {} };
+    }
+
+    const auto frame = edges.last(rht03_frame_edges);
+    const auto interval = [&frame](size_t edge) { return static_cast<uint16_t>(frame[edge + 1] - frame[edge]); };
+    const auto in_range = [](uint16_t value, uint16_t min, uint16_t max) { return value >= min && value <= max; };
+
+    if (!in_range(interval(0), rht03_min_ack_us, rht03_max_ack_us) || !in_range(interval(1), rht03_min_ack_us, rht03_max_ack_us))
+    {
+        return { RHT03Status::BadAcknowledge, {} };
+    }
+
+    std::array<uint16_t, rht03_frame_bits> highs{};
+    uint32_t lows_sum = 0;
+    for (size_t bit = 0; bit < rht03_frame_bits; ++bit)
+    {
+        const auto low = interval(2 + 2 * bit);
+        highs[bit] = interval(3 + 2 * bit);
+        if (!in_range(low, rht03_min_bit_low_us, rht03_max_bit_low_us) || !in_range(highs[bit], rht03_min_bit_high_us, rht03_max_bit_high_us))
+        {
+            return { RHT03Status::BadBit, {} };
+        }
+        lows_sum += low;
+    }
+
+    const auto threshold = RHT03BitThreshold(highs, lows_sum, classifier);
+    uint16_t margin = UINT16_MAX;
+    std::array<uint8_t, rht03_frame_bytes> bytes{};
+    for (size_t bit = 0; bit < rht03_frame_bits; ++bit)
+    {
+        const bool is_one = highs[bit] > threshold;
+        const auto distance = static_cast<uint16_t>(is_one ? highs[bit] - threshold : threshold - highs[bit]);
+        margin = distance < margin ? distance : margin;
+
+        auto& byte = bytes[bit / 8];
+        byte = static_cast<uint8_t>((byte << 1) | (is_one ? 1 : 0));
+    }
+
+    if (static_cast<uint8_t>(bytes[0] + bytes[1] + bytes[2] + bytes[3]) != bytes[4])
+    {
+        return { RHT03Status::ChecksumMismatch, {}, threshold, margin };
+    }
+
+    // Both are in tenths. The temperature is sign and magnitude, with the sign in the top bit.
+    const int32_t humidity = bytes[0] << 8 | bytes[1];
+    const int32_t temp_magnitude = (bytes[2] & 0x7F) << 8 | bytes[3];
+    const bool temp_negative = (bytes[2] & 0x80) != 0;
+    return { RHT03Status::Ok, { Tenths::FromRaw(humidity), Tenths::FromRaw(temp_negative ? -temp_magnitude : temp_magnitude) }, threshold, margin };
+}
+
+// Durations in us of each part of a frame, for making up edges to decode.
+struct RHT03Timing
+{
+    uint16_t response = 30;     // From the host releasing the line to the acknowledge.
+    uint16_t ack_low = 80;
+    uint16_t ack_high = 80;
+    uint16_t bit_low = 50;
+    uint16_t zero_high = 27;
+    uint16_t one_high = 70;
+    uint16_t end_low = 50;
+};
+
+// Edges of a frame as the capture sees them, starting with the host releasing the line at start.
+[[nodiscard]] constexpr std::array<uint16_t, rht03_frame_edges + 1> MakeRHT03Edges(const std::array<uint8_t, rht03_frame_bytes>& bytes,
+    uint16_t start, const RHT03Timing& timing = {}) noexcept
+{
+    std::array<uint16_t, rht03_frame_edges + 1> edges{};
+    size_t count = 0;
+    uint16_t time = start;
+    const auto add = [&](uint16_t duration)
+    {
+        edges[count++] = time;
+        time = static_cast<uint16_t>(time + duration);
+    };
+
+    add(timing.response);
+    add(timing.ack_low);
+    add(timing.ack_high);
+    for (size_t bit = 0; bit < rht03_frame_bits; ++bit)
+    {
+        add(timing.bit_low);
+        add(((bytes[bit / 8] >> (7 - bit % 8)) & 1) != 0 ? timing.one_high : timing.zero_high);
+    }
+    add(timing.end_low);
+    add(0);
+    return edges;
+}
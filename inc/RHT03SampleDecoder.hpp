@@ -0,0 +1,130 @@
+#pragma once
+#include "RHT03Decoder.hpp"
+#include <array>
+#include <cstdint>
+#include <span>
+
+// Decoding of RHT03 frames on several pins from samples of their port's IDR, one every us. A single pass over the
+// samples turns every pin's level changes into edge times in us, and each pin's edges then go through DecodeRHT03
+// as if they had been captured. Nothing here touches the hardware.
+
+// The response, acknowledge, 40 bits of 1s and the end take about 5.2 ms. The rest is for a slow sensor clock.
+inline constexpr size_t rht03_port_samples = 6000;
+
+// Pins are GPIO_PIN_x masks, one per sensor. Sample i is taken at i us, so the samples have to fit in the 16 bit
+// edge times, and only the last rht03_frame_edges changes of each pin are kept, since the frame is at the end.
+template<size_t N>
+[[nodiscard]] constexpr std::array<RHT03Result, N> DecodeRHT03Samples(std::span<const uint16_t> samples,
+    const std::array<uint16_t, N>& pins, RHT03BitClassifier classifier = RHT03BitClassifier::TwoCluster) noexcept
+{
+    uint16_t mask = 0;
+    for (auto pin : pins)
+    {
+        mask |= pin;
+    }
+
+    // A ring of edges per pin. Most samples change nothing, so they cost one XOR and a compare for every pin.
+    std::array<std::array<uint16_t, rht03_frame_edges>, N> rings{};
+    std::array<size_t, N> counts{};
+    for (size_t i = 1; i < samples.size(); ++i)
+    {
+        const auto changed = static_cast<uint16_t>((samples[i] ^ samples[i - 1]) & mask);
+        if (changed == 0)
+        {
+            continue;
+        }
+
+        for (size_t p = 0; p < N; ++p)
+        {
+            if ((changed & pins[p]) != 0)
+            {
+                rings[p][counts[p]++ % rht03_frame_edges] = static_cast<uint16_t>(i);
+            }
+        }
+    }
+
+    std::array<RHT03Result, N> results{};
+    for (size_t p = 0; p < N; ++p)
+    {
+        // A line still low at the end was cut off in the middle of its frame.
+        if (counts[p] < rht03_frame_edges || samples.empty() || (samples.back() & pins[p]) == 0)
+        {
+            results[p] = { RHT03Status::MissingEdges, {} };
+            continue;
+        }
+
+        std::array<uint16_t, rht03_frame_edges> edges{};
+        for (size_t edge = 0; edge < rht03_frame_edges; ++edge)
+        {
+            edges[edge] = rings[p][(counts[p] + edge) % rht03_frame_edges];
+        }
+        results[p] = DecodeRHT03(edges, classifier);
+    }
+    return results;
+}
+
+// Samples of a port as the DMA would store them, with a frame made by MakeRHT03Edges on each pin. Every line is
+// held low by the host until its first edge. The noise pins toggle every sample, like another user of the port.
+template<size_t N>
+[[nodiscard]] constexpr std::array<uint16_t, rht03_port_samples> MakeRHT03Samples(const std::array<uint16_t, N>& pins,
+    const std::array<std::array<uint16_t, rht03_frame_edges + 1>, N>& edges, uint16_t noise_pins = 0) noexcept
+{
+    std::array<uint16_t, rht03_port_samples> samples{};
+    std::array<size_t, N> next{};
+    uint16_t levels = 0;
+    for (size_t i = 0; i < samples.size(); ++i)
+    {
+        for (size_t p = 0; p < N; ++p)
+        {
+            while (next[p] < edges[p].size() && edges[p][next[p]] == i)
+            {
+                levels ^= pins[p];
+                ++next[p];
+            }
+        }
+        samples[i] = static_cast<uint16_t>(levels | (i % 2 != 0 ? noise_pins : 0));
+    }
+    return samples;
+}
+
+// Checks of the sample decoder, on samples made up from frames on a few pins of one port.
+constexpr bool DecodedAs(const RHT03Result& result, RHT03Status status, int32_t humidity = 0, int32_t temp = 0) noexcept
+{
+    return result.status == status
+        && (status != RHT03Status::Ok || (result.reading.humidity.Raw() == humidity && result.reading.temp.Raw() == temp));
+}
+
+static_assert(rht03_port_samples <= 0x10000, "Sample indices are the 16 bit edge times");
+
+// Three sensors answering at slightly different times, one with a 40 % fast clock and one with a bad checksum,
+// next to a pin that isn't a sensor's. None of them disturbs the others.
+static_assert([]()
+{
+    constexpr std::array<uint16_t, 3> pins{ 1u << 8, 1u << 9, 1u << 11 };
+    const auto samples = MakeRHT03Samples(pins,
+        { {
+            MakeRHT03Edges({ 0x02, 0x8C, 0x01, 0x5F, 0xEE }, 20),
+            MakeRHT03Edges({ 0x01, 0xF4, 0x80, 0x65, 0xDA }, 23, { .ack_low = 48, .ack_high = 48, .bit_low = 30, .zero_high = 16, .one_high = 42, .end_low = 30 }),
+            MakeRHT03Edges({ 0x02, 0x8C, 0x01, 0x5F, 0xEF }, 21)
+        } },
+        1u << 10);
+    const auto results = DecodeRHT03Samples(samples, pins);
+    return DecodedAs(results[0], RHT03Status::Ok, 652, 351)
+        && DecodedAs(results[1], RHT03Status::Ok, 500, -101)
+        && DecodedAs(results[2], RHT03Status::ChecksumMismatch);
+}());
+
+// A sensor that answers too late to fit in the samples, and a pin with nothing on it.
+static_assert([]()
+{
+    constexpr std::array<uint16_t, 2> pins{ 1u << 0, 1u << 1 };
+    const auto samples = MakeRHT03Samples(pins,
+        { {
+            MakeRHT03Edges({ 0x02, 0x8C, 0x01, 0x5F, 0xEE }, 4000),
+            MakeRHT03Edges({ 0x02, 0x8C, 0x01, 0x5F, 0xEE }, 20)
+        } });
+    const auto results = DecodeRHT03Samples(samples, std::array<uint16_t, 3>{ 1u << 0, 1u << 1, 1u << 2 });
+    return DecodedAs(results[0], RHT03Status::MissingEdges)
+        && DecodedAs(results[1], RHT03Status::Ok, 652, 351)
+        && DecodedAs(results[2], RHT03Status::MissingEdges);
+}());
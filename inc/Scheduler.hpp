@@ -0,0 +1,107 @@
+#pragma once
+#include "SteadyClock.hpp"
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <optional>
+
+struct SchedulerJobStats
+{
+    uint32_t runs;
+    uint32_t late_runs;                 // Runs that started a tick or more after their deadline.
+    uint32_t skipped_periods;           // Periods dropped because the previous run overran them.
+    SteadyClock::duration max_lateness;
+};
+
+// Runs jobs at 1 ms ticks from a hierarchical timer wheel, and sleeps in WFI until the next one is due.
+//
+// There are three levels of 64 slots, covering 64 ms, 4 s and 4.4 min. A job goes in the finest level that reaches
+// its deadline and moves down a level each time the wheel passes the start of its slot, so inserting and expiring
+// a job are O(1). Periods are kept by adding the period to the previous deadline rather than to the time the job
+// ran, so a periodic job doesn't drift.
+//
+// The wake up comes from TIM2 channel 1, which compares against the same counter as SteadyClock. SysTick is
+// suspended while sleeping so it doesn't wake the CPU every ms, which means HAL_GetTick() doesn't count the time
+// spent asleep.
+//
+// Not interrupt safe. Jobs are scheduled and run from the main loop.
+class Scheduler
+{
+public:
+    using Callback = void (*)(void* context);
+    using Condition = bool (*)(void* context);
+    using JobId = uint8_t;
+
+    static constexpr size_t max_jobs = 16;
+    using tick = std::chrono::milliseconds;
+
+    Scheduler() noexcept;
+
+    // The first run is after first_delay, and then every period after the previous deadline.
+    [[nodiscard]] std::optional<JobId> SchedulePeriodic(tick period, Callback callback, void* context, tick first_delay) noexcept;
+    [[nodiscard]] std::optional<JobId> SchedulePeriodic(tick period, Callback callback, void* context) noexcept
+    {
+        return SchedulePeriodic(period, callback, context, period);
+    }
+    [[nodiscard]] std::optional<JobId> ScheduleOnce(tick delay, Callback callback, void* context) noexcept;
+    // Can be called from a job, including on itself.
+    void Cancel(JobId id) noexcept;
+
+    [[nodiscard]] SchedulerJobStats GetStats(JobId id) const noexcept;
+
+    // Runs the jobs that are due and returns.
+    void RunPending() noexcept;
+    // Sleeps until the next job is due or an interrupt fires. has_work is checked with interrupts masked, so an
+    // interrupt that makes work after the check still ends the sleep, and the sleep is skipped if it returns true.
+    void Idle(Condition has_work = nullptr, void* context = nullptr) noexcept;
+    // Runs jobs forever, sleeping between them.
+    [[noreturn]] void Run() noexcept;
+
+    // Follows jobs through the wheel from their insertion to their run, on ticks worked out rather than counted.
+    // Checks each one only ever sits in a slot the wheel reaches within one turn, and runs on its deadline.
+    [[nodiscard]] static constexpr bool IsWheelValid() noexcept;
+
+private:
+    static constexpr size_t wheel_levels = 3;
+    static constexpr size_t slot_bits = 6;
+    static constexpr size_t wheel_slots = 1u << slot_bits;
+    static constexpr uint32_t max_delay_ticks = 1u << (slot_bits * wheel_levels);
+    static constexpr int8_t no_job = -1;
+
+    struct WheelPosition
+    {
+        uint32_t level;
+        uint32_t slot;
+        uint32_t start;         // Tick at which the wheel reaches the slot and takes the job out of it.
+    };
+
+    struct Job
+    {
+        Callback callback;
+        void* context;
+        uint32_t deadline;
+        uint32_t period;        // In ticks. 0 for one shot jobs.
+        int8_t prev;
+        int8_t next;
+        uint8_t level;
+        uint8_t slot;
+        bool active;
+        bool queued;            // In the wheel. Not while the job runs.
+        SchedulerJobStats stats;
+    };
+
+    std::array<Job, max_jobs> m_jobs{};
+    std::array<std::array<int8_t, wheel_slots>, wheel_levels> m_wheel;
+    uint32_t m_current = 0;     // Last tick the wheel has processed.
+    size_t m_active_jobs = 0;
+
+    [[nodiscard]] static uint32_t Now() noexcept;
+    [[nodiscard]] std::optional<JobId> Add(uint32_t delay, uint32_t period, Callback callback, void* context) noexcept;
+    [[nodiscard]] static constexpr WheelPosition Place(uint32_t current, uint32_t deadline) noexcept;
+    void Insert(JobId id) noexcept;
+    void Remove(JobId id) noexcept;
+    void Advance() noexcept;
+    void Execute(JobId id) noexcept;
+    // Next tick the wheel has to be processed at, if there are any jobs.
+    [[nodiscard]] std::optional<uint32_t> NextWake() const noexcept;
+};
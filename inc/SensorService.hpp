@@ -0,0 +1,115 @@
+#pragma once
+#include "RHT03.hpp"
+#include "SteadyClock.hpp"
+#include "Task.hpp"
+#include <chrono>
+#include <cstdint>
+
+struct SensorPolicy
+{
+    // The RHT03 needs 2 s between reads, and as long after power up.
+    std::chrono::milliseconds min_interval{ 2000 };
+    // Reads of anything older ask for a refresh, and it is flagged stale.
+    std::chrono::milliseconds max_age{ 4000 };
+    // Readings whose bits came closer than this to the threshold are flagged.
+    uint16_t low_margin_us = 8;
+};
+
+struct SensorSnapshot
+{
+    RHT03Reading reading;               // Last good reading.
+    SteadyClock::time_point timestamp;  // When the last good reading was taken.
+    SteadyClock::duration age;
+    uint32_t sequence;                  // Counts every finished read, good or not.
+    RHT03Status last_status;            // Of the latest read.
+    bool is_valid;                      // There has been a good reading.
+    bool is_stale;                      // Invalid, or older than the policy's max age.
+    bool is_low_margin;
+};
+
+// Owns the RHT03's reads and caches the last good one, so any number of consumers can read at any rate without
+// touching the bus. Reads are answered from the cache at once. A stale one, or a wait for the next update, asks
+// for a refresh, which the service's task does in the background no sooner than the policy's min_interval after
+// the previous read.
+//
+// Not interrupt safe. Use from tasks on the same executor.
+class SensorService
+{
+public:
+    // Counts power up as a read, so the first one is min_interval from here.
+    SensorService(RHT03& sensor, Executor& executor, const SensorPolicy& policy = {}) noexcept;
+
+    // Runs the reads. Spawn once.
+    [[nodiscard]] Task Run() noexcept;
+
+    [[nodiscard]] SensorSnapshot Read() noexcept
+    {
+        return Read(m_policy.max_age);
+    }
+    // A consumer can ask for fresher data than the policy, but not get it faster than min_interval.
+    [[nodiscard]] SensorSnapshot Read(std::chrono::milliseconds max_age) noexcept;
+
+    void RequestRefresh() noexcept
+    {
+        m_refresh_requested = true;
+    }
+
+    // Waits until a read newer than sequence has finished, and asks for one.
+    class UpdateAwaiter
+    {
+    public:
+        UpdateAwaiter(const UpdateAwaiter&) = delete;
+        UpdateAwaiter& operator=(const UpdateAwaiter&) = delete;
+
+        [[nodiscard]] bool await_ready() const noexcept
+        {
+            return m_awaiter.await_ready();
+        }
+
+        [[nodiscard]] bool await_suspend(std::coroutine_handle<> handle) noexcept
+        {
+            return m_awaiter.await_suspend(handle);
+        }
+
+        bool await_resume() const noexcept
+        {
+            return m_awaiter.await_resume();
+        }
+
+    private:
+        friend class SensorService;
+
+        const SensorService& m_service;
+        uint32_t m_sequence;
+        // Points back at this awaiter, which stays put in the task's frame while it is suspended.
+        Executor::ConditionAwaiter m_awaiter;
+
+        UpdateAwaiter(SensorService& service, uint32_t sequence) noexcept :
+            m_service{ service }, m_sequence{ sequence }, m_awaiter{ service.m_executor.WaitUntil(IsUpdated, this) }
+        {
+            service.RequestRefresh();
+        }
+
+        static bool IsUpdated(void* context) noexcept
+        {
+            const auto& awaiter = *static_cast<UpdateAwaiter*>(context);
+            return awaiter.m_service.m_snapshot.sequence != awaiter.m_sequence;
+        }
+    };
+
+    [[nodiscard]] UpdateAwaiter WaitForUpdate(uint32_t sequence) noexcept
+    {
+        return UpdateAwaiter{ *this, sequence };
+    }
+
+private:
+    RHT03& m_sensor;
+    Executor& m_executor;
+    SensorPolicy m_policy;
+    SensorSnapshot m_snapshot{};
+    SteadyClock::time_point m_last_read;
+    bool m_refresh_requested = false;
+
+    [[nodiscard]] static bool IsRefreshRequested(void* context) noexcept;
+    void Update(const RHT03Result& result) noexcept;
+};
@@ -1,4 +1,10 @@
 #pragma once
 
-bool Print(const char* format, ...);
-bool PrintLine(const char* format, ...);
\ No newline at end of file
+// The format attributes have the compiler check every call's arguments against its format string.
+bool Print(const char* format, ...) __attribute__((format(printf, 1, 2)));
+bool PrintLine(const char* format, ...) __attribute__((format(printf, 1, 2)));
+
+// Sends in the background from an internal buffer and returns at once. Fails if the previous line is still being
+// sent, so wait for IsTransmitDone() first.
+bool PrintLineAsync(const char* format, ...) __attribute__((format(printf, 1, 2)));
+bool IsTransmitDone();
\ No newline at end of file
@@ -0,0 +1,23 @@
+#pragma once
+#include <chrono>
+#include <cstdint>
+#include <ratio>
+
+// Monotonic clock at the 10 MHz rate of TIM2. The hardware counter is 32 bits and wraps every 429 s, so the
+// TIM2 update interrupt counts the wraps into the upper 32 bits. Satisfies the std::chrono Clock requirements.
+class SteadyClock
+{
+public:
+    using rep = int64_t;
+    using period = std::ratio<1, 10'000'000>;
+    using duration = std::chrono::duration<rep, period>;
+    using time_point = std::chrono::time_point<SteadyClock>;
+    static constexpr bool is_steady = true;
+
+    // Lock free. Safe from any interrupt priority, including ones that block the TIM2 interrupt.
+    [[nodiscard]] static time_point now() noexcept;
+
+    // Call from the TIM2 update interrupt.
+    static void OnOverflow() noexcept;
+};
+static_assert(std::chrono::is_clock_v<SteadyClock>);
@@ -0,0 +1,293 @@
+#pragma once
+#include "PinEdge.hpp"
+#include "Scheduler.hpp"
+#include "SteadyClock.hpp"
+#include <array>
+#include <coroutine>
+#include <cstddef>
+#include <cstdint>
+
+// Coroutine frames come from a fixed number of fixed size blocks in .bss, so spawning a task never touches the heap
+// and can't fragment. The compiler only knows a frame's size at the call that allocates it, so an oversized frame
+// is caught there: the allocation fails and the task is never created. LargestFrame() reports the biggest frame
+// requested so far, to size block_size against, and main checks it once every task is spawned.
+class TaskArena
+{
+public:
+    static constexpr size_t block_size = 512;
+    // main's tasks: the sensor service, the display, the telemetry and, with RHT03_ARRAY, the array reader. There is
+    // a spare block on top, so one more task doesn't need the arena resized.
+    static constexpr size_t max_tasks = 4;
+    static constexpr size_t block_count = max_tasks + 1;
+    static_assert(block_size % alignof(std::max_align_t) == 0, "Every block has to be aligned for any frame");
+    static_assert(block_size * block_count <= 4 * 1024, "The arena is meant to be a small part of the RAM");
+
+    // nullptr if size is more than block_size or every block is in use.
+    [[nodiscard]] static void* Allocate(size_t size) noexcept;
+    static void Free(void* block) noexcept;
+
+    [[nodiscard]] static size_t LargestFrame() noexcept;
+    [[nodiscard]] static uint32_t FailedAllocations() noexcept;
+};
+
+// A coroutine that runs on an Executor. Nothing waits for a task to finish, so its frame frees itself when the
+// body returns. Exceptions are disabled, so a frame that can't be allocated gives an empty task instead.
+class Task
+{
+public:
+    struct promise_type
+    {
+        [[nodiscard]] Task get_return_object() noexcept
+        {
+            return Task{ std::coroutine_handle<promise_type>::from_promise(*this) };
+        }
+
+        [[nodiscard]] static Task get_return_object_on_allocation_failure() noexcept
+        {
+            return Task{};
+        }
+
+        // Tasks start when they are spawned, not when they are called.
+        std::suspend_always initial_suspend() noexcept
+        {
+            return {};
+        }
+
+        std::suspend_never final_suspend() noexcept
+        {
+            return {};
+        }
+
+        void return_void() noexcept
+        {
+
+        }
+
+        void unhandled_exception() noexcept
+        {
+
+        }
+
+        static void* operator new(size_t size) noexcept
+        {
+            return TaskArena::Allocate(size);
+        }
+
+        static void operator delete(void* frame) noexcept
+        {
+            TaskArena::Free(frame);
+        }
+    };
+
+    Task() noexcept = default;
+    Task(Task&& other) noexcept : m_handle{ other.m_handle }
+    {
+        other.m_handle = nullptr;
+    }
+    Task& operator=(Task&&) = delete;
+    // A task that was never spawned is destroyed without running.
+    ~Task()
+    {
+        if (m_handle)
+        {
+            m_handle.destroy();
+        }
+    }
+
+    [[nodiscard]] bool IsValid() const noexcept
+    {
+        return static_cast<bool>(m_handle);
+    }
+
+private:
+    friend class Executor;
+
+    std::coroutine_handle<promise_type> m_handle;
+
+    explicit Task(std::coroutine_handle<promise_type> handle) noexcept : m_handle{ handle }
+    {
+
+    }
+};
+
+// Runs tasks on top of a Scheduler. A task runs until it awaits one of:
+//  - Delay() or DelayUntil(), which is a one shot job on the scheduler.
+//  - WaitUntil(), a condition set by an interrupt, e.g. a DMA or UART transfer being done.
+//  - WaitForEdge(), an edge on a pin.
+// Conditions are checked after every interrupt and job, and the CPU sleeps in between like it does for the
+// scheduler alone.
+//
+// Not interrupt safe. Tasks are spawned and resumed from the main loop.
+class Executor
+{
+public:
+    // A suspended task waits on one thing at a time and owns a block of the arena, so one waiter per block, spare
+    // included, means there is always a free one. AddWaiter still checks, and a task that finds none carries on as
+    // if its condition was met.
+    static constexpr size_t max_waiters = TaskArena::block_count;
+
+    explicit Executor(Scheduler& scheduler) noexcept : m_scheduler{ scheduler }
+    {
+
+    }
+
+    // Runs the task until it first suspends. False if the task is empty because its frame couldn't be allocated.
+    [[nodiscard]] bool Spawn(Task task) noexcept;
+
+    // Runs jobs and tasks forever, sleeping when there is nothing to do.
+    [[noreturn]] void Run() noexcept;
+
+    class DelayAwaiter
+    {
+    public:
+        [[nodiscard]] bool await_ready() const noexcept
+        {
+            return m_delay.count() <= 0;
+        }
+
+        [[nodiscard]] bool await_suspend(std::coroutine_handle<> handle) noexcept
+        {
+            m_waited = m_executor.m_scheduler.ScheduleOnce(m_delay, Resume, handle.address()).has_value();
+            return m_waited;
+        }
+
+        // False if the scheduler had no free job, in which case the task carried on without waiting.
+        bool await_resume() const noexcept
+        {
+            return m_waited;
+        }
+
+    private:
+        friend class Executor;
+
+        Executor& m_executor;
+        Scheduler::tick m_delay;
+        bool m_waited = true;
+
+        DelayAwaiter(Executor& executor, Scheduler::tick delay) noexcept : m_executor{ executor }, m_delay{ delay }
+        {
+
+        }
+
+        static void Resume(void* context) noexcept
+        {
+            std::coroutine_handle<>::from_address(context).resume();
+        }
+    };
+
+    class ConditionAwaiter
+    {
+    public:
+        [[nodiscard]] bool await_ready() const noexcept
+        {
+            return m_condition(m_context);
+        }
+
+        [[nodiscard]] bool await_suspend(std::coroutine_handle<> handle) noexcept
+        {
+            m_waited = m_executor.AddWaiter(handle, m_condition, m_context);
+            return m_waited;
+        }
+
+        // False if there was no free waiter, in which case the task carried on without waiting.
+        bool await_resume() const noexcept
+        {
+            return m_waited;
+        }
+
+    private:
+        friend class Executor;
+
+        Executor& m_executor;
+        Scheduler::Condition m_condition;
+        void* m_context;
+        bool m_waited = true;
+
+        ConditionAwaiter(Executor& executor, Scheduler::Condition condition, void* context) noexcept :
+            m_executor{ executor }, m_condition{ condition }, m_context{ context }
+        {
+
+        }
+    };
+
+    // The pin is armed when the awaiter is made, so an edge between that and the suspension isn't missed.
+    class EdgeAwaiter
+    {
+    public:
+        EdgeAwaiter(const EdgeAwaiter&) = delete;
+        EdgeAwaiter& operator=(const EdgeAwaiter&) = delete;
+
+        [[nodiscard]] bool await_ready() const noexcept
+        {
+            return HasPinEdge(m_pin);
+        }
+
+        // The waiter points at the awaiter, which stays put in the task's frame while it is suspended.
+        [[nodiscard]] bool await_suspend(std::coroutine_handle<> handle) noexcept
+        {
+            m_waited = m_executor.AddWaiter(handle, HasEdge, this);
+            return m_waited;
+        }
+
+        // False if there was no free waiter, in which case the task carried on without waiting.
+        bool await_resume() const noexcept
+        {
+            return m_waited;
+        }
+
+    private:
+        friend class Executor;
+
+        Executor& m_executor;
+        GPIOPin m_pin;
+        bool m_waited = true;
+
+        EdgeAwaiter(Executor& executor, const GPIOPin& pin, PinEdge edge) noexcept : m_executor{ executor }, m_pin{ pin }
+        {
+            ArmPinEdge(pin, edge);
+        }
+
+        static bool HasEdge(void* context) noexcept
+        {
+            return HasPinEdge(static_cast<EdgeAwaiter*>(context)->m_pin);
+        }
+    };
+
+    [[nodiscard]] DelayAwaiter Delay(Scheduler::tick delay) noexcept
+    {
+        return DelayAwaiter{ *this, delay };
+    }
+
+    // Rounded up to the scheduler's tick.
+    [[nodiscard]] DelayAwaiter DelayUntil(SteadyClock::time_point deadline) noexcept
+    {
+        return DelayAwaiter{ *this, std::chrono::ceil<Scheduler::tick>(deadline - SteadyClock::now()) };
+    }
+
+    // The condition must only depend on state that changes in interrupts or in the main loop.
+    [[nodiscard]] ConditionAwaiter WaitUntil(Scheduler::Condition condition, void* context = nullptr) noexcept
+    {
+        return ConditionAwaiter{ *this, condition, context };
+    }
+
+    [[nodiscard]] EdgeAwaiter WaitForEdge(const GPIOPin& pin, PinEdge edge) noexcept
+    {
+        return EdgeAwaiter{ *this, pin, edge };
+    }
+
+private:
+    struct Waiter
+    {
+        std::coroutine_handle<> handle;
+        Scheduler::Condition condition;
+        void* context;
+    };
+
+    Scheduler& m_scheduler;
+    std::array<Waiter, max_waiters> m_waiters{};
+
+    // False if every waiter is taken.
+    [[nodiscard]] bool AddWaiter(std::coroutine_handle<> handle, Scheduler::Condition condition, void* context) noexcept;
+    void ResumeReady() noexcept;
+    [[nodiscard]] static bool HasReadyWaiter(void* context) noexcept;
+};
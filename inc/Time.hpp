@@ -1,7 +1,34 @@
 #pragma once
+#include "stm32l4xx.h"
+#include <chrono>
 #include <cstdint>
 
-uint32_t Timer_100ns();
+// Must match the SYSCLK set up by SystemClock_Config.
+inline constexpr uint32_t core_clock_hz = 80'000'000;
+
+// Rounds up, so a delay is never shorter than asked for.
+consteval uint32_t ToCycles(std::chrono::nanoseconds duration)
+{
+	return static_cast<uint32_t>((duration.count() * core_clock_hz + 999'999'999) / 1'000'000'000);
+}
+static_assert(ToCycles(std::chrono::nanoseconds{ 30 }) == 3 && ToCycles(std::chrono::nanoseconds{ 400 }) == 32);
+
+// Starts the DWT cycle counter. Call once after the clocks are configured.
+void Time_Init();
+
+// Microseconds from SteadyClock, truncated to 32 bits. Differences are valid across the wrap.
 uint32_t Timer_us();
-void Delay_100ns(uint32_t multiplier);
-void Delay_us(uint32_t delay);
\ No newline at end of file
+
+// The cycle counter wraps every 53 s at 80 MHz, which is fine for intervals shorter than that.
+inline uint32_t Cycles()
+{
+	return DWT->CYCCNT;
+}
+
+inline void Delay_cycles(uint32_t cycles)
+{
+	const uint32_t start = Cycles();
+	while (Cycles() - start < cycles) ;
+}
+
+void Delay_us(uint32_t delay);
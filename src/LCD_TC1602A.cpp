@@ -1,26 +1,121 @@
 #include "LCD_TC1602A.hpp"
+#include "LCDBus.hpp"
+#include "HALPorts.hpp"
 #include "Pins.hpp"
 #include "Time.hpp"
 #include "Serial.hpp"
 #include "stm32l4xx_hal.h"
+#include <algorithm>
 #include <array>
+#include <bit>
 #include <span>
 
+extern TIM_HandleTypeDef htim1;
+extern TIM_HandleTypeDef htim6;
+extern DMA_HandleTypeDef hdma_tim1_ch1;
+extern DMA_HandleTypeDef hdma_tim1_ch2;
+extern DMA_HandleTypeDef hdma_tim1_ch3;
+
 namespace
 {
-    std::array<std::pair<GPIO_TypeDef*, uint16_t>, 8> lcd_data_pins
-    { {
-        { LCD_D0_GPIO_Port, LCD_D0_Pin },
-        { LCD_D1_GPIO_Port, LCD_D1_Pin },
-        { LCD_D2_GPIO_Port, LCD_D2_Pin },
-        { LCD_D3_GPIO_Port, LCD_D3_Pin },
-        { LCD_D4_GPIO_Port, LCD_D4_Pin },
-        { LCD_D5_GPIO_Port, LCD_D5_Pin },
-        { LCD_D6_GPIO_Port, LCD_D6_Pin },
-        { LCD_D7_GPIO_Port, LCD_D7_Pin }
-    } };
+    // The data bus is shared by every command, so its direction is cached here rather than per call.
+    // The direction is unknown until the first switch since MX_GPIO_Init configures the pins.
+    struct DataBusState
+    {
+        bool direction_known = false;
+        bool is_output = false;
+        LCD_TC1602A::BusStats stats{};
+        // Set while a command is on the bus. Panels share it, and an async panel's TIM6 interrupt can land in the
+        // middle of another panel's command from the main loop.
+        volatile bool in_use = false;
+    };
+
+    DataBusState data_bus;
+
+    class BusLock
+    {
+    public:
+        [[nodiscard]] BusLock() noexcept
+        {
+            data_bus.in_use = true;
+        }
+
+        ~BusLock() noexcept
+        {
+            data_bus.in_use = false;
+        }
+
+        BusLock(const BusLock&) = delete;
+        BusLock& operator=(const BusLock&) = delete;
+    };
 
     static constexpr uint32_t max_command_time_ms = 5;  // Datasheet says 4.1ms max for clear display and return home.
+    static constexpr uint32_t poll_interval_us = 1;
+    static constexpr uint32_t async_poll_interval_us = 2;
+    static constexpr uint32_t status_read_time_us = 1;     // Rough cost of one busy flag read, including the bus turnaround.
+
+    // Bus timings from the datasheet, waited in CPU cycles.
+    using namespace std::chrono_literals;
+    constexpr uint32_t address_setup_cycles = ToCycles(30ns);   // tSP1, RS and RW before E rises.
+    constexpr uint32_t enable_pulse_cycles = ToCycles(150ns);   // tPW
+    constexpr uint32_t enable_cycle_cycles = ToCycles(400ns);   // tC, from one E rise to the next.
+    constexpr uint32_t data_delay_cycles = ToCycles(100ns);     // tD, E rise to read data valid.
+
+#ifdef LCD_TC1602A_WRITE_ONLY
+    // The busy flag is never read, so every command waits its execution time and RW can be tied low.
+    constexpr bool write_only = true;
+#else
+    constexpr bool write_only = false;
+#endif
+
+    // Only the write only mode relies on the execution times being long enough, so only it pays for the margin.
+    constexpr uint32_t timing_margin_percent = write_only ? LCD_TC1602A_TIMING_MARGIN_PERCENT : 0;
+    constexpr auto execution_time_us = LCDExecutionTimes(timing_margin_percent);
+    static_assert(execution_time_us[static_cast<size_t>(LCDCommandClass::ClearDisplay)] < 0xFFFF, "The margin is too large for TIM6");
+
+    // TIM6 counts at 1 MHz in one pulse mode. An update event happens after ARR + 1 ticks and ARR must not be 0.
+    // Returns the delay that was actually used.
+    uint32_t StartAsyncTimer(uint32_t delay_us) noexcept
+    {
+        delay_us = std::max<uint32_t>(delay_us, 2);
+        __HAL_TIM_SET_AUTORELOAD(&htim6, delay_us - 1);
+        __HAL_TIM_SET_COUNTER(&htim6, 0);
+        __HAL_TIM_ENABLE(&htim6);
+        return delay_us;
+    }
+
+    // TIM1 CC1, CC2 and CC3 each request one BSRR word per slot for ports A, B and C. Port B's channel has the
+    // lowest DMA priority so its transfer complete is the last word of the sequence on any port.
+    DMA_HandleTypeDef* const sequence_dma[gpio_port_count]{ &hdma_tim1_ch1, &hdma_tim1_ch2, &hdma_tim1_ch3 };
+    constexpr size_t sequence_complete_port = static_cast<size_t>(GPIOPort::B);
+
+    // The idle slots after the last write cover its execution time, so the sequence is done when the DMA is.
+    std::array<std::array<uint32_t, LCDBusSlots(lcd_max_sequence_writes)>, gpio_port_count> sequence_buffers{};
+
+    LCD_TC1602A* sequence_owner = nullptr;
+
+    // Bytes that can be written from address before the address counter leaves the current DDRAM row. In two row
+    // mode the rows are 0x00 - 0x27 and 0x40 - 0x67 and the addresses in between don't exist.
+    constexpr size_t DDRAMRunLength(uint8_t address, bool two_rows, bool increment) noexcept
+    {
+        const size_t row_start = !two_rows || address < 0x40 ? 0x00 : 0x40;
+        const size_t row_end = !two_rows ? 0x50 : row_start + 0x28;
+        if (address >= row_end)
+        {
+            return 0;
+        }
+        return increment ? row_end - address : address - row_start + 1;
+    }
+    static_assert(DDRAMRunLength(0x00, true, true) == 40 && DDRAMRunLength(0x27, true, true) == 1);
+    static_assert(DDRAMRunLength(0x50, true, true) == 24, "Column 16 of the second row");
+    static_assert(DDRAMRunLength(0x28, true, true) == 0 && DDRAMRunLength(0x68, true, true) == 0);
+    static_assert(DDRAMRunLength(0x50, false, true) == 0 && DDRAMRunLength(0x30, false, true) == 32);
+    static_assert(DDRAMRunLength(0x45, true, false) == 6);
+
+    void OnSequenceTransferComplete(DMA_HandleTypeDef*) noexcept
+    {
+        sequence_owner->OnSequenceComplete();
+    }
 }
 
 class AutoEnable
@@ -42,8 +137,16 @@ private:
 
 void LCD_TC1602A::Init(const LCDInit& init) noexcept
 {
+    // MX_GPIO_Init only knows lcd_e_pin, so every panel sets up its own E pin, as a push-pull output held low.
+    // The ports' clocks are already on.
+    const uint32_t e_moder_shift = 2 * static_cast<uint32_t>(std::countr_zero(m_e_pin.pin));
+    HALPorts::Regs(m_e_pin.port)->BSRR = MakePinWord(m_e_pin, false);
+    SetPinModes(HALPorts::Regs(m_e_pin.port), 0b11u << e_moder_shift, 0b01u << e_moder_shift);
+
     HAL_Delay(80);  // Datasheet says > 40 ms after VDD > 2.7 V. Wait double to be sure.
 
+    m_two_rows = init.row_count == LCDInit::Rows::Two;
+
     data_t data;
     data.set(static_cast<size_t>(CommandIndex::Function));
     data.set(4, static_cast<bool>(init.data_size));
@@ -73,7 +176,7 @@ void LCD_TC1602A::SetSettings(const LCDSettings& settings) noexcept
     data.set(2, settings.display_on);
     data.set(1, settings.cursor_on);
     data.set(0, settings.cursor_blink);
-    SendWriteCommand(RegisterSelect::Instruction, data);
+    SendWriteCommandAndWait(RegisterSelect::Instruction, data);
 }
 
 void LCD_TC1602A::Clear() noexcept
@@ -120,17 +223,34 @@ void LCD_TC1602A::SetDisplayScrollDirection(LCDScrollDirection dir) noexcept
 
 uint8_t LCD_TC1602A::Read() noexcept
 {
+    if constexpr (write_only)
+    {
+        return 0;
+    }
+
+    // The read runs for as long as a write, so the next command, e.g. one queued for the interrupt, would find the
+    // controller busy.
+    WaitUntilIdle();
     auto data = SendReadCommand(RegisterSelect::Data);
+    AdvanceAddress();
+    WaitUntilReady(CommandClass::DataRead, max_command_time_ms);
     return static_cast<uint8_t>(data.to_ulong());
 }
 
 size_t LCD_TC1602A::Read(std::span<uint8_t> buffer) noexcept
 {
+    if constexpr (write_only)
+    {
+        return 0;
+    }
+
+    WaitUntilIdle();
     for (auto& byte : buffer)
     {
         auto data = SendReadCommand(RegisterSelect::Data);
         byte = static_cast<uint8_t>(data.to_ulong());
-        WaitUntilReady(max_command_time_ms);
+        AdvanceAddress();
+        WaitUntilReady(CommandClass::DataRead, max_command_time_ms);
     }
     return buffer.size();
 }
@@ -142,21 +262,298 @@ void LCD_TC1602A::Write(uint8_t data) noexcept
 
 size_t LCD_TC1602A::Write(const std::span<uint8_t>& data) noexcept
 {
-    static constexpr size_t max_address = 80;
-
-    uint8_t curr_address;
-    UNUSED(IsBusy(curr_address));
-    auto end_address = std::min(curr_address + data.size(), max_address);
-    auto size = end_address - curr_address;
-
+    // The address is tracked in software so there is no need to read it back, or to drain the queue in async mode.
+    // The run stops at the end of the row rather than following the address counter into the other one.
+    const auto available = m_address_type == LCDAddress::DDRAM
+        ? DDRAMRunLength(m_address, m_two_rows, m_increment)
+        : m_increment ? 64u - m_address : m_address + 1u;
+    const auto size = std::min(data.size(), available);
+
+    // In async mode the run goes straight into the queue. Otherwise each byte only waits for the one before it,
+    // and the last one is left for the next command to wait for.
+    const bool deferred_wait = m_deferred_wait;
+    m_deferred_wait = !write_only;
     for (auto byte : data.subspan(0, size))
     {
         SendWriteCommandAndWait(RegisterSelect::Data, byte);
     }
+    m_deferred_wait = deferred_wait;
     return size;
 }
 
 bool LCD_TC1602A::IsBusy(uint8_t& address_counter) noexcept
+{
+    WaitForSequence();
+    WaitForFrame(MarkFrame());
+    if constexpr (write_only)
+    {
+        // Every command has finished by the time it returns, but the address counter can only be tracked.
+        address_counter = m_address;
+        return false;
+    }
+
+    const bool busy = ReadStatus(address_counter);
+    m_command_pending = m_command_pending && busy;
+    return busy;
+}
+
+bool LCD_TC1602A::VerifyAddressCounter() noexcept
+{
+    WaitUntilIdle();
+    uint8_t address_counter = m_address;
+    UNUSED(IsBusy(address_counter));
+    if (address_counter == m_address)
+    {
+        return true;
+    }
+
+    ++m_address_mismatches;
+    m_address = address_counter;
+    return false;
+}
+
+void LCD_TC1602A::SetDeferredWait(bool enable) noexcept
+{
+    if (!enable)
+    {
+        WaitForPendingCommand();
+    }
+    m_deferred_wait = enable && !write_only;
+}
+
+void LCD_TC1602A::SetAsync(bool enable) noexcept
+{
+    if (!enable)
+    {
+        WaitUntilIdle();
+    }
+    m_async = enable;
+}
+
+uint32_t LCD_TC1602A::MarkFrame() const noexcept
+{
+    return m_queue_head.load();
+}
+
+bool LCD_TC1602A::IsFrameComplete(uint32_t frame) const noexcept
+{
+    return static_cast<int32_t>(m_queue_tail.load() - frame) >= 0;
+}
+
+void LCD_TC1602A::WaitForFrame(uint32_t frame) noexcept
+{
+    while (!IsFrameComplete(frame)) ;
+}
+
+bool LCD_TC1602A::IsIdle() const noexcept
+{
+    return IsFrameComplete(MarkFrame());
+}
+
+void LCD_TC1602A::WaitUntilIdle() noexcept
+{
+    WaitForSequence();
+    WaitForFrame(MarkFrame());
+    WaitForPendingCommand();
+}
+
+bool LCD_TC1602A::WriteSequence(std::span<const LCDBusWrite> writes, void (*on_complete)(void*), void* context) noexcept
+{
+    if (m_sequence_running || writes.size() > lcd_max_sequence_writes)
+    {
+        return false;
+    }
+
+    for (const auto& write : writes)
+    {
+        const auto rs = write.is_data ? RegisterSelect::Data : RegisterSelect::Instruction;
+        const auto command_class = GetCommandClass(rs, write.value);
+        if (command_class == CommandClass::ClearDisplay || command_class == CommandClass::ReturnHome)
+        {
+            return false;
+        }
+    }
+
+    if (writes.empty())
+    {
+        if (on_complete != nullptr)
+        {
+            on_complete(context);
+        }
+        return true;
+    }
+
+    // The queue and the sequence would both drive the bus.
+    WaitUntilIdle();
+
+    std::array<std::span<uint32_t>, gpio_port_count> out{};
+    for (size_t port = 0; port < gpio_port_count; ++port)
+    {
+        out[port] = sequence_buffers[port];
+    }
+    const auto slot_count = ExpandBusWrites(writes, out, m_e_pin);
+    if (slot_count == 0)
+    {
+        return false;
+    }
+
+    for (const auto& write : writes)
+    {
+        TrackAddress(write.is_data ? RegisterSelect::Data : RegisterSelect::Instruction, write.value);
+    }
+
+    SetupDataPins(IOMode::Write);
+    if constexpr (!write_only)
+    {
+        SetIOMode(IOMode::Write);
+    }
+
+    m_sequence_on_complete = on_complete;
+    m_sequence_context = context;
+    m_sequence_running = true;
+    sequence_owner = this;
+
+    for (size_t port = 0; port < gpio_port_count; ++port)
+    {
+        auto* dma = sequence_dma[port];
+        const auto source = static_cast<uint32_t>(reinterpret_cast<uintptr_t>(sequence_buffers[port].data()));
+        const auto destination = static_cast<uint32_t>(reinterpret_cast<uintptr_t>(&HALPorts::Regs(static_cast<GPIOPort>(port))->BSRR));
+        if (port == sequence_complete_port)
+        {
+            dma->XferCpltCallback = OnSequenceTransferComplete;
+            HAL_DMA_Start_IT(dma, source, destination, slot_count);
+        }
+        else
+        {
+            HAL_DMA_Start(dma, source, destination, slot_count);
+        }
+    }
+
+    // A compare at 0 would be the counter's starting value, which isn't a match, so the first slot would wait a
+    // whole period or be lost. CCRx is preloaded with 1 instead, so the first slot is requested one tick after the
+    // counter starts and every slot after it one period apart.
+    __HAL_TIM_SET_COUNTER(&htim1, 0);
+    for (auto channel : { TIM_CHANNEL_1, TIM_CHANNEL_2, TIM_CHANNEL_3 })
+    {
+        __HAL_TIM_SET_COMPARE(&htim1, channel, 1);
+    }
+    __HAL_TIM_ENABLE_DMA(&htim1, TIM_DMA_CC1 | TIM_DMA_CC2 | TIM_DMA_CC3);
+    __HAL_TIM_ENABLE(&htim1);
+    return true;
+}
+
+void LCD_TC1602A::OnSequenceComplete() noexcept
+{
+    __HAL_TIM_DISABLE(&htim1);
+    __HAL_TIM_DISABLE_DMA(&htim1, TIM_DMA_CC1 | TIM_DMA_CC2 | TIM_DMA_CC3);
+
+    // The other channels have transferred everything, but HAL only returns them to ready when aborted.
+    for (size_t port = 0; port < gpio_port_count; ++port)
+    {
+        if (port != sequence_complete_port)
+        {
+            HAL_DMA_Abort(sequence_dma[port]);
+        }
+    }
+
+    m_sequence_running = false;
+    if (m_sequence_on_complete != nullptr)
+    {
+        m_sequence_on_complete(m_sequence_context);
+    }
+}
+
+void LCD_TC1602A::WaitForSequence() const noexcept
+{
+    while (m_sequence_running) ;
+}
+
+void LCD_TC1602A::WaitForPendingCommand() noexcept
+{
+    if (!m_command_pending)
+    {
+        return;
+    }
+
+    // Like WaitUntilReady(), but the command has been running since it was sent. If the caller only comes back
+    // after the poll start, a command that is already done says nothing about how long it took, so the latency is
+    // only recorded when polling starts on time or the command was still busy.
+    const auto elapsed = [this]() { return Timer_us() - m_pending_start_us; };
+    const uint32_t poll_start_us = GetPollStart(m_pending_class);
+    uint32_t elapsed_us = elapsed();
+    bool is_measured = elapsed_us <= poll_start_us;
+    if (is_measured)
+    {
+        Delay_us(poll_start_us - elapsed_us);
+    }
+
+    uint8_t ac = 0;
+    while (ReadStatus(ac))
+    {
+        is_measured = true;
+        if (elapsed() >= max_command_time_ms * 1000)
+        {
+            m_command_pending = false;
+            return;
+        }
+        Delay_us(poll_interval_us);
+    }
+
+    if (is_measured)
+    {
+        RecordLatency(m_pending_class, elapsed());
+    }
+    m_command_pending = false;
+}
+
+LCD_TC1602A::LatencyStats LCD_TC1602A::GetLatencyStats(CommandClass command_class) const noexcept
+{
+    const auto& latency = m_latency[static_cast<size_t>(command_class)];
+    return { latency.average_16ths / 16, latency.max_us, latency.samples };
+}
+
+void LCD_TC1602A::OnTimerElapsed() noexcept
+{
+    // The interrupt can't wait for the bus, so it comes back once another panel's command or a sequence is done.
+    if (data_bus.in_use || (sequence_owner != nullptr && sequence_owner->IsSequenceRunning()))
+    {
+        const auto delay_us = StartAsyncTimer(async_poll_interval_us);
+        m_in_flight_elapsed_us += m_command_in_flight ? delay_us : 0;
+        return;
+    }
+
+    auto tail = m_queue_tail.load();
+    if (m_command_in_flight)
+    {
+        // The command's expected execution time has passed. The controller may still be slower than expected.
+        uint8_t ac = 0;
+        if (!write_only && ReadStatus(ac))
+        {
+            m_in_flight_elapsed_us += StartAsyncTimer(async_poll_interval_us);
+            return;
+        }
+
+        if constexpr (!write_only)
+        {
+            RecordLatency(m_queue[tail % m_queue.size()].command_class, m_in_flight_elapsed_us);
+        }
+        m_command_in_flight = false;
+        m_queue_tail.store(++tail);
+    }
+
+    if (tail == m_queue_head.load())
+    {
+        m_queue_running = false;
+        return;
+    }
+
+    const auto& command = m_queue[tail % m_queue.size()];
+    SendWriteCommand(command.rs, command.data);
+    m_command_in_flight = true;
+    m_in_flight_elapsed_us = StartAsyncTimer(GetPollStart(command.command_class));
+}
+
+bool LCD_TC1602A::ReadStatus(uint8_t& address_counter) noexcept
 {
     static constexpr data_t address_mask{ 0b1111111 };
 
@@ -165,24 +562,63 @@ bool LCD_TC1602A::IsBusy(uint8_t& address_counter) noexcept
     return data.test(7);
 }
 
-bool LCD_TC1602A::WaitUntilReady(uint32_t timeout_ms) noexcept
+bool LCD_TC1602A::WaitUntilReady(CommandClass command_class, uint32_t timeout_ms) noexcept
 {
-    static constexpr uint32_t poll_interval_us = 10;
-    const uint32_t max_cycles = (timeout_ms * 1000) / poll_interval_us;
+    const uint32_t timeout_us = timeout_ms * 1000;
+    uint32_t elapsed_us = GetPollStart(command_class);
+    Delay_us(elapsed_us);
 
-    for (uint32_t i = 0; i < max_cycles; ++i)
+    while (true)
     {
-        Delay_us(poll_interval_us);
-
         uint8_t ac = 0;
-        auto is_busy = IsBusy(ac);
-        if (!is_busy)
+        if (!ReadStatus(ac))
         {
+            RecordLatency(command_class, elapsed_us);
             return true;
         }
+
+        if (elapsed_us >= timeout_us)
+        {
+            return false;
+        }
+
+        Delay_us(poll_interval_us);
+        elapsed_us += poll_interval_us + status_read_time_us;
     }
+}
 
-    return false;
+uint32_t LCD_TC1602A::GetPollStart(CommandClass command_class) const noexcept
+{
+    const auto index = static_cast<size_t>(command_class);
+    if constexpr (write_only)
+    {
+        return execution_time_us[index];
+    }
+
+    const auto& latency = m_latency[index];
+    const uint32_t expected_us = latency.samples == 0 ? execution_time_us[index] : latency.average_16ths / 16;
+
+    // Start a little early. If polling started at the average, a command that got faster would never be measured as such.
+    const uint32_t backoff_us = std::max<uint32_t>(expected_us / 8, 2);
+    return expected_us - std::min(expected_us, backoff_us);
+}
+
+void LCD_TC1602A::RecordLatency(CommandClass command_class, uint32_t latency_us) noexcept
+{
+    // Exponential moving average with a weight of 1/8, kept in 1/16 us to not lose the small steps.
+    auto& latency = m_latency[static_cast<size_t>(command_class)];
+    const auto sample = static_cast<int32_t>(latency_us * 16);
+    if (latency.samples == 0)
+    {
+        latency.average_16ths = sample;
+    }
+    else
+    {
+        const auto average = static_cast<int32_t>(latency.average_16ths);
+        latency.average_16ths = static_cast<uint32_t>(average + (sample - average) / 8);
+    }
+    latency.max_us = std::max(latency.max_us, latency_us);
+    ++latency.samples;
 }
 
 void LCD_TC1602A::SetEntryMode(TextDirection dir, bool enableDisplayScroll) noexcept
@@ -196,124 +632,207 @@ void LCD_TC1602A::SetEntryMode(TextDirection dir, bool enableDisplayScroll) noex
 
 void LCD_TC1602A::SetupDataPins(IOMode mode) noexcept
 {
-    GPIO_InitTypeDef init{};
-    init.Pull = GPIO_NOPULL;
-    switch (mode)
+    const bool is_output = mode == IOMode::Write;
+    if (data_bus.direction_known && data_bus.is_output == is_output)
     {
-    case IOMode::Write:
-        init.Mode = GPIO_MODE_OUTPUT_PP;
-        init.Speed = GPIO_SPEED_FREQ_LOW;
-        break;
-
-    case IOMode::Read:
-        init.Mode = GPIO_MODE_INPUT;
-        break;
+        ++data_bus.stats.direction_switches_avoided;
+        return;
     }
 
-    init.Pin = LCD_D2_Pin | LCD_D3_Pin | LCD_D6_Pin | LCD_D7_Pin;
-    HAL_GPIO_Init(GPIOA, &init);
+    // Pull, speed and output type were set by MX_GPIO_Init.
+    LCDDataBus::SetOutput(is_output);
 
-    init.Pin = LCD_D0_Pin | LCD_D1_Pin | LCD_D5_Pin;
-    HAL_GPIO_Init(GPIOB, &init);
+    data_bus.direction_known = true;
+    data_bus.is_output = is_output;
+    ++data_bus.stats.direction_switches;
+}
 
-    init.Pin = LCD_D4_Pin;
-    HAL_GPIO_Init(GPIOC, &init);
+LCD_TC1602A::BusStats LCD_TC1602A::GetBusStats() noexcept
+{
+    return data_bus.stats;
 }
 
 void LCD_TC1602A::SetRS(RegisterSelect rs) noexcept
 {
-    auto pin_state = [rs]() 
-    {
-        switch (rs)
-        {
-        case RegisterSelect::Instruction: return GPIO_PIN_RESET;
-        case RegisterSelect::Data: return GPIO_PIN_SET;
-        }
-        __unreachable();
-    }();
-    HAL_GPIO_WritePin(LCD_RS_GPIO_Port, LCD_RS_Pin, pin_state);
+    IOPin<lcd_rs_pin>::Write(rs == RegisterSelect::Data);
 }
 
 void LCD_TC1602A::SetIOMode(IOMode mode) noexcept
 {
-    auto pin_state = [mode]() 
-    {
-        switch (mode)
-        {
-        case IOMode::Write: return GPIO_PIN_RESET;
-        case IOMode::Read: return GPIO_PIN_SET;
-        }
-        __unreachable();
-    }();
-    HAL_GPIO_WritePin(LCD_RW_GPIO_Port, LCD_RW_Pin, pin_state);
+    IOPin<lcd_rw_pin>::Write(mode == IOMode::Read);
 }
 
 void LCD_TC1602A::SetEnable(bool enable) noexcept
 {
-    HAL_GPIO_WritePin(LCD_E_GPIO_Port, LCD_E_Pin, enable ? GPIO_PIN_SET : GPIO_PIN_RESET);
+    HALPorts::Regs(m_e_pin.port)->BSRR = MakePinWord(m_e_pin, enable);
 }
 
 void LCD_TC1602A::SetData(data_t data) noexcept
 {
-    for (size_t i = 0; i < lcd_data_pins.size(); ++i)
-    {
-        auto& pin = lcd_data_pins[i];
-        HAL_GPIO_WritePin(pin.first, pin.second, data.test(i) ? GPIO_PIN_SET : GPIO_PIN_RESET);
-    }
+    LCDDataBus::Write(static_cast<uint8_t>(data.to_ulong()));
 }
 
 LCD_TC1602A::data_t LCD_TC1602A::ReadData() noexcept
 {
-    data_t data;
-    for (size_t i = 0; i < lcd_data_pins.size(); ++i)
-    {
-        auto& pin = lcd_data_pins[i];
-        auto state = HAL_GPIO_ReadPin(pin.first, pin.second);
-        data.set(i, state != GPIO_PIN_RESET);
-    }
-    return data;
+    return LCDDataBus::Read();
 }
 
 void LCD_TC1602A::SetupCommand(RegisterSelect rs, IOMode mode) noexcept
 {
     SetRS(rs);
-    SetIOMode(mode);
-    Delay_100ns(1); // tSP1 is 30 ns
+    if constexpr (!write_only)
+    {
+        SetIOMode(mode);
+    }
+    Delay_cycles(address_setup_cycles);
 }
 
 void LCD_TC1602A::SendWriteCommand(RegisterSelect rs, data_t data) noexcept
 {
     static constexpr auto mode = IOMode::Write;
 
+    BusLock bus_lock;
     SetupDataPins(mode);
     SetupCommand(rs, mode);
     {
         AutoEnable auto_enable{ *this };
         SetData(data);
-        Delay_100ns(2);	// Min tPW is 150ns.
+        Delay_cycles(enable_pulse_cycles);
     }
-    Delay_100ns(2);	// Min cycle time is 400ns.
+    Delay_cycles(enable_cycle_cycles - enable_pulse_cycles);
 }
 
 void LCD_TC1602A::SendWriteCommandAndWait(RegisterSelect rs, data_t data) noexcept
 {
+    WaitForSequence();
+    TrackAddress(rs, data);
+    if (m_async)
+    {
+        Enqueue(rs, data);
+        return;
+    }
+
+    WaitForPendingCommand();
     SendWriteCommand(rs, data);
-    WaitUntilReady(max_command_time_ms);
+    if (m_deferred_wait)
+    {
+        m_command_pending = true;
+        m_pending_class = GetCommandClass(rs, data);
+        m_pending_start_us = Timer_us();
+        return;
+    }
+
+    if constexpr (write_only)
+    {
+        Delay_us(GetPollStart(GetCommandClass(rs, data)));
+    }
+    else
+    {
+        WaitUntilReady(GetCommandClass(rs, data), max_command_time_ms);
+    }
+}
+
+void LCD_TC1602A::Enqueue(RegisterSelect rs, data_t data) noexcept
+{
+    auto head = m_queue_head.load();
+    while (head - m_queue_tail.load() >= m_queue.size()) ;  // Full, wait for the interrupt to drain it.
+
+    m_queue[head % m_queue.size()] = { rs, static_cast<uint8_t>(data.to_ulong()), GetCommandClass(rs, data) };
+    m_queue_head.store(head + 1);
+
+    // The interrupt clears m_queue_running when it finds the queue empty, so check and restart atomically.
+    auto primask = __get_PRIMASK();
+    __disable_irq();
+    if (!m_queue_running)
+    {
+        m_queue_running = true;
+        StartAsyncTimer(0);
+    }
+    __set_PRIMASK(primask);
+}
+
+void LCD_TC1602A::TrackAddress(RegisterSelect rs, data_t data) noexcept
+{
+    const auto value = static_cast<uint8_t>(data.to_ulong());
+    switch (GetCommandClass(rs, data))
+    {
+    case CommandClass::ClearDisplay:
+        m_increment = true;    // Clear display also sets the entry mode to increment.
+        [[fallthrough]];
+    case CommandClass::ReturnHome:
+        m_address_type = LCDAddress::DDRAM;
+        m_address = 0;
+        break;
+
+    case CommandClass::EntryMode:
+        m_increment = data.test(1);
+        break;
+
+    case CommandClass::CGRAMAddress:
+        m_address_type = LCDAddress::CGRAM;
+        m_address = value & 0x3F;
+        break;
+
+    case CommandClass::DDRAMAddress:
+        m_address_type = LCDAddress::DDRAM;
+        m_address = value & 0x7F;
+        break;
+
+    case CommandClass::DataWrite:
+    case CommandClass::DataRead:
+        AdvanceAddress();
+        break;
+
+    default:
+        break;
+    }
+}
+
+void LCD_TC1602A::AdvanceAddress() noexcept
+{
+    if (m_address_type == LCDAddress::CGRAM)
+    {
+        m_address = (m_address + (m_increment ? 1 : -1)) & 0x3F;
+        return;
+    }
+
+    // DDRAM is 0x00 - 0x4F in one row mode. In two row mode it is 0x00 - 0x27 and 0x40 - 0x67, and the
+    // address counter jumps from the end of one row to the start of the other.
+    if (!m_two_rows)
+    {
+        m_address = m_increment ? (m_address == 0x4F ? 0x00 : m_address + 1) : (m_address == 0x00 ? 0x4F : m_address - 1);
+        return;
+    }
+
+    if (m_increment)
+    {
+        m_address = m_address == 0x27 ? 0x40 : m_address == 0x67 ? 0x00 : m_address + 1;
+    }
+    else
+    {
+        m_address = m_address == 0x40 ? 0x27 : m_address == 0x00 ? 0x67 : m_address - 1;
+    }
+}
+
+LCD_TC1602A::CommandClass LCD_TC1602A::GetCommandClass(RegisterSelect rs, data_t data) noexcept
+{
+    return LCDCommandClassOf(rs == RegisterSelect::Data, static_cast<uint8_t>(data.to_ulong()));
 }
 
 LCD_TC1602A::data_t LCD_TC1602A::SendReadCommand(RegisterSelect rs) noexcept
 {
     static constexpr auto mode = IOMode::Read;
 
+    BusLock bus_lock;
     SetupDataPins(mode);
     SetupCommand(rs, mode);
     data_t data;
     {
         AutoEnable auto_enable{ *this };
-        Delay_100ns(1); // tD max = 100 ns
+        Delay_cycles(data_delay_cycles);
         data = ReadData();
-        Delay_100ns(1);  // tPW min = 150 ns
+        Delay_cycles(enable_pulse_cycles - data_delay_cycles);
     }
-    Delay_100ns(2); // tC min = 400 ns
+    Delay_cycles(enable_cycle_cycles - enable_pulse_cycles);
     return data;
 }
\ No newline at end of file
@@ -0,0 +1,72 @@
+#include "PinEdge.hpp"
+#include <bit>
+
+namespace
+{
+    // Lines whose armed edge has happened, by GPIO_PIN_x mask.
+    volatile uint16_t pending_edges = 0;
+
+    // EXTICR selects the port of each line with the same numbering as GPIOPort.
+    static_assert(static_cast<uint32_t>(GPIOPort::A) == 0 && static_cast<uint32_t>(GPIOPort::B) == 1 && static_cast<uint32_t>(GPIOPort::C) == 2);
+}
+
+void ArmPinEdge(const GPIOPin& pin, PinEdge edge) noexcept
+{
+    // An unmasked line without a handler would interrupt forever.
+    if (!IsPinEdgeLine(pin))
+    {
+        return;
+    }
+
+    const auto line = std::countr_zero(pin.pin);
+    const auto shift = 4 * (line % 4);
+
+    // Lines 0 - 15 are the low bits of the EXTI registers, so the pin mask is also the line mask. Callers may
+    // already have interrupts disabled, so PRIMASK is restored rather than cleared.
+    const uint32_t primask = __get_PRIMASK();
+    __disable_irq();
+    EXTI->IMR1 &= ~pin.pin;
+    SYSCFG->EXTICR[line / 4] = (SYSCFG->EXTICR[line / 4] & ~(0xFu << shift)) | (static_cast<uint32_t>(pin.port) << shift);
+    if (edge == PinEdge::Falling)
+    {
+        EXTI->RTSR1 &= ~pin.pin;
+    }
+    else
+    {
+        EXTI->RTSR1 |= pin.pin;
+    }
+    if (edge == PinEdge::Rising)
+    {
+        EXTI->FTSR1 &= ~pin.pin;
+    }
+    else
+    {
+        EXTI->FTSR1 |= pin.pin;
+    }
+    EXTI->PR1 = pin.pin;
+    pending_edges = pending_edges & ~pin.pin;
+    EXTI->IMR1 |= pin.pin;
+    __set_PRIMASK(primask);
+}
+
+void DisarmPinEdge(const GPIOPin& pin) noexcept
+{
+    const uint32_t primask = __get_PRIMASK();
+    __disable_irq();
+    EXTI->IMR1 &= ~pin.pin;
+    EXTI->PR1 = pin.pin;
+    pending_edges = pending_edges & ~pin.pin;
+    __set_PRIMASK(primask);
+}
+
+bool HasPinEdge(const GPIOPin& pin) noexcept
+{
+    return (pending_edges & pin.pin) != 0;
+}
+
+void OnPinEdgeInterrupt(uint16_t pin) noexcept
+{
+    // Only the first edge counts, so the line stops interrupting until it is armed again.
+    EXTI->IMR1 &= ~pin;
+    pending_edges = pending_edges | pin;
+}
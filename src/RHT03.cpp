@@ -0,0 +1,148 @@
+#include "RHT03.hpp"
+#include "HALPorts.hpp"
+#include "Pins.hpp"
+#include "stm32l4xx_hal.h"
+#include <bit>
+
+extern TIM_HandleTypeDef htim16;
+
+namespace
+{
+    constexpr uint32_t moder_shift = 2 * std::countr_zero(temp_data_pin.pin);
+
+    // The counter wraps, and ends the start pulse, start_pulse after it starts from here.
+    constexpr uint16_t start_pulse_count = static_cast<uint16_t>(0x10000 - std::chrono::microseconds{ RHT03::start_pulse }.count());
+
+    // Edges stored by the time each state starts.
+    constexpr size_t acknowledge_edges = 2;     // Release and the acknowledge's falling edge.
+    constexpr size_t data_edges = 4;            // And the acknowledge's rising edge, and the first bit's falling edge.
+
+    // Only MODER changes. Open drain, the pull-up and AF14 are set up once by MX_GPIO_Init. TIM16 only sees the
+    // line in its alternate function, so the switch back has to happen as the start pulse ends, in the interrupt.
+    void SetOutput(bool is_output) noexcept
+    {
+        const uint32_t mode = is_output ? 0b01 : 0b10;
+        SetPinModes(HALPorts::Regs(temp_data_pin.port), 0b11u << moder_shift, mode << moder_shift);
+    }
+
+    uint16_t SinceStart(uint16_t count) noexcept
+    {
+        return static_cast<uint16_t>(count - start_pulse_count);
+    }
+}
+
+bool RHT03::StartRead() noexcept
+{
+    if (IsReading() || !IOPin<temp_data_pin>::Read())
+    {
+        return false;
+    }
+
+    m_timeline = {};
+    m_timeline.start = SteadyClock::now();
+    m_timeline.last_state = RHT03State::StartPulse;
+    m_state = RHT03State::StartPulse;
+
+    IOPin<temp_data_pin>::Write(false);
+    SetOutput(true);
+    __HAL_TIM_SET_COUNTER(&htim16, start_pulse_count);
+    __HAL_TIM_CLEAR_FLAG(&htim16, TIM_FLAG_UPDATE);
+    __HAL_TIM_ENABLE_IT(&htim16, TIM_IT_UPDATE);
+    __HAL_TIM_ENABLE(&htim16);
+    return true;
+}
+
+RHT03State RHT03::GetState() const noexcept
+{
+    const auto state = m_state;
+    if (state != RHT03State::Release)
+    {
+        return state;
+    }
+
+    const auto edges = CapturedEdges();
+    return edges >= data_edges ? RHT03State::Data : edges >= acknowledge_edges ? RHT03State::Acknowledge : RHT03State::Release;
+}
+
+void RHT03::CancelRead() noexcept
+{
+    // Masked so the read can't move on between the check and the stop, and overwrite the result.
+    __disable_irq();
+    if (m_state == RHT03State::StartPulse)
+    {
+        __HAL_TIM_DISABLE_IT(&htim16, TIM_IT_UPDATE);
+        __HAL_TIM_DISABLE(&htim16);
+        SetOutput(false);
+    }
+    else if (m_state == RHT03State::Release)
+    {
+        RecordTimeline(CapturedEdges());
+        HAL_TIM_IC_Stop_DMA(&htim16, TIM_CHANNEL_1);
+    }
+
+    if (m_state != RHT03State::Idle)
+    {
+        m_result = { RHT03Status::MissingEdges, {} };
+        m_state = RHT03State::Idle;
+    }
+    __enable_irq();
+}
+
+void RHT03::OnStartPulseElapsed() noexcept
+{
+    __HAL_TIM_DISABLE_IT(&htim16, TIM_IT_UPDATE);
+    if (m_state != RHT03State::StartPulse)
+    {
+        return;
+    }
+
+    // The capture sees the line rise as soon as it is released, so the first edge is always the host's.
+    m_state = RHT03State::Release;
+    m_timeline.last_state = RHT03State::Release;
+    if (HAL_TIM_IC_Start_DMA(&htim16, TIM_CHANNEL_1, reinterpret_cast<uint32_t*>(m_edges.data()), m_edges.size()) != HAL_OK)
+    {
+        __HAL_TIM_DISABLE(&htim16);
+        m_result = { RHT03Status::MissingEdges, {} };
+        m_state = RHT03State::Idle;
+    }
+    SetOutput(false);
+}
+
+void RHT03::OnCaptureComplete() noexcept
+{
+    m_state = RHT03State::Decode;
+    m_result = DecodeRHT03(m_edges);
+    RecordTimeline(capture_edges);
+    m_timeline.decode_us = SinceStart(static_cast<uint16_t>(__HAL_TIM_GET_COUNTER(&htim16)));
+    m_timeline.last_state = RHT03State::Decode;
+
+    HAL_TIM_IC_Stop_DMA(&htim16, TIM_CHANNEL_1);
+    m_state = RHT03State::Idle;
+}
+
+size_t RHT03::CapturedEdges() const noexcept
+{
+    return capture_edges - __HAL_DMA_GET_COUNTER(htim16.hdma[TIM_DMA_ID_CC1]);
+}
+
+void RHT03::RecordTimeline(size_t edges) noexcept
+{
+    if (edges >= 1)
+    {
+        m_timeline.release_us = SinceStart(m_edges[0]);
+    }
+    if (edges >= acknowledge_edges)
+    {
+        m_timeline.acknowledge_us = SinceStart(m_edges[acknowledge_edges - 1]);
+        m_timeline.last_state = RHT03State::Acknowledge;
+    }
+    if (edges >= data_edges)
+    {
+        m_timeline.data_us = SinceStart(m_edges[data_edges - 1]);
+        m_timeline.last_state = RHT03State::Data;
+    }
+    if (edges == capture_edges)
+    {
+        m_timeline.end_us = SinceStart(m_edges[capture_edges - 1]);
+    }
+}
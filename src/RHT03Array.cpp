@@ -0,0 +1,102 @@
+#include "RHT03Array.hpp"
+#include "HALPorts.hpp"
+#include "stm32l4xx_hal.h"
+#include <algorithm>
+
+extern TIM_HandleTypeDef htim15;
+extern DMA_HandleTypeDef hdma_tim15_up;
+
+RHT03Array::RHT03Array(std::span<const GPIOPin> pins) noexcept : m_port{ pins.empty() ? GPIOPort::A : pins.front().port }
+{
+    for (const auto& pin : pins.first(std::min(pins.size(), max_sensors)))
+    {
+        m_pins[m_size++] = pin.pin;
+        m_lines |= pin.pin;
+    }
+    m_results.fill({ RHT03Status::MissingEdges, {} });
+}
+
+bool RHT03Array::BeginRead() noexcept
+{
+    auto* gpio = HALPorts::Regs(m_port);
+    if (IsReading() || (gpio->IDR & m_lines) != m_lines)
+    {
+        return false;
+    }
+
+    m_has_samples = false;
+    m_is_pulsing = true;
+    gpio->BSRR = static_cast<uint32_t>(m_lines) << 16;
+    return true;
+}
+
+void RHT03Array::Release() noexcept
+{
+    if (!m_is_pulsing)
+    {
+        return;
+    }
+
+    // Sampling starts before the release so the sensors' response, 20 - 40 us later, is never missed. The
+    // release shows up as every line's first edge, which the decoder skips.
+    auto* gpio = HALPorts::Regs(m_port);
+    const auto source = static_cast<uint32_t>(reinterpret_cast<uintptr_t>(&gpio->IDR));
+    const auto destination = static_cast<uint32_t>(reinterpret_cast<uintptr_t>(m_samples.data()));
+    m_is_pulsing = false;
+    m_is_sampling = true;
+    if (HAL_DMA_Start_IT(&hdma_tim15_up, source, destination, m_samples.size()) != HAL_OK)
+    {
+        m_is_sampling = false;
+        m_results.fill({ RHT03Status::MissingEdges, {} });
+    }
+    else
+    {
+        __HAL_TIM_SET_COUNTER(&htim15, 0);
+        __HAL_TIM_ENABLE_DMA(&htim15, TIM_DMA_UPDATE);
+        __HAL_TIM_ENABLE(&htim15);
+    }
+    gpio->BSRR = m_lines;
+}
+
+void RHT03Array::CancelRead() noexcept
+{
+    // Masked so sampling can't complete between the check and the stop.
+    __disable_irq();
+    if (m_is_sampling)
+    {
+        StopSampling();
+        HAL_DMA_Abort(&hdma_tim15_up);
+    }
+    if (IsReading())
+    {
+        m_results.fill({ RHT03Status::MissingEdges, {} });
+    }
+    m_is_pulsing = false;
+    HALPorts::Regs(m_port)->BSRR = m_lines;
+    __enable_irq();
+}
+
+void RHT03Array::Decode() noexcept
+{
+    if (m_is_sampling || !m_has_samples)
+    {
+        return;
+    }
+
+    m_has_samples = false;
+    const auto results = DecodeRHT03Samples(m_samples, m_pins);
+    std::copy_n(results.begin(), m_size, m_results.begin());
+}
+
+void RHT03Array::OnSamplingComplete() noexcept
+{
+    StopSampling();
+    m_has_samples = true;
+}
+
+void RHT03Array::StopSampling() noexcept
+{
+    __HAL_TIM_DISABLE(&htim15);
+    __HAL_TIM_DISABLE_DMA(&htim15, TIM_DMA_UPDATE);
+    m_is_sampling = false;
+}
@@ -0,0 +1,316 @@
+#include "Scheduler.hpp"
+#include "stm32l4xx_hal.h"
+#include <algorithm>
+
+extern TIM_HandleTypeDef htim2;
+
+Scheduler::Scheduler() noexcept
+{
+    for (auto& level : m_wheel)
+    {
+        level.fill(no_job);
+    }
+    m_current = Now();
+}
+
+std::optional<Scheduler::JobId> Scheduler::SchedulePeriodic(tick period, Callback callback, void* context, tick first_delay) noexcept
+{
+    if (period.count() <= 0)
+    {
+        return std::nullopt;
+    }
+    return Add(static_cast<uint32_t>(first_delay.count()), static_cast<uint32_t>(period.count()), callback, context);
+}
+
+std::optional<Scheduler::JobId> Scheduler::ScheduleOnce(tick delay, Callback callback, void* context) noexcept
+{
+    return Add(static_cast<uint32_t>(delay.count()), 0, callback, context);
+}
+
+void Scheduler::Cancel(JobId id) noexcept
+{
+    auto& job = m_jobs[id];
+    if (!job.active)
+    {
+        return;
+    }
+
+    if (job.queued)
+    {
+        Remove(id);
+    }
+    job.active = false;
+    --m_active_jobs;
+}
+
+SchedulerJobStats Scheduler::GetStats(JobId id) const noexcept
+{
+    return m_jobs[id].stats;
+}
+
+void Scheduler::RunPending() noexcept
+{
+    const uint32_t now = Now();
+    while (static_cast<int32_t>(now - m_current) > 0)
+    {
+        ++m_current;
+        Advance();
+    }
+}
+
+void Scheduler::Idle(Condition has_work, void* context) noexcept
+{
+    // Without a job, only an interrupt can make work.
+    std::optional<SteadyClock::time_point> target;
+    if (auto wake = NextWake())
+    {
+        const auto now_tick = std::chrono::floor<tick>(SteadyClock::now().time_since_epoch());
+        target = SteadyClock::time_point{ now_tick + tick{ static_cast<int32_t>(*wake - static_cast<uint32_t>(now_tick.count())) } };
+    }
+
+    // With interrupts masked, a compare or interrupt that happens after the checks still ends the WFI, and is
+    // serviced after.
+    __disable_irq();
+    if (target)
+    {
+        __HAL_TIM_SET_COMPARE(&htim2, TIM_CHANNEL_1, static_cast<uint32_t>(target->time_since_epoch().count()));
+    }
+    const bool is_due = target && SteadyClock::now() >= *target;
+    if (!is_due && (has_work == nullptr || !has_work(context)))
+    {
+        HAL_SuspendTick();
+        __WFI();
+        HAL_ResumeTick();
+    }
+    __enable_irq();
+}
+
+void Scheduler::Run() noexcept
+{
+    while (true)
+    {
+        RunPending();
+        Idle();
+    }
+}
+
+uint32_t Scheduler::Now() noexcept
+{
+    const auto now = std::chrono::duration_cast<tick>(SteadyClock::now().time_since_epoch());
+    return static_cast<uint32_t>(now.count());
+}
+
+std::optional<Scheduler::JobId> Scheduler::Add(uint32_t delay, uint32_t period, Callback callback, void* context) noexcept
+{
+    auto it = std::find_if(m_jobs.begin(), m_jobs.end(), [](const Job& job) { return !job.active; });
+    if (it == m_jobs.end() || callback == nullptr)
+    {
+        return std::nullopt;
+    }
+
+    // The wheel has already processed the current tick, so the earliest a job can run is the next one.
+    *it = {};
+    it->callback = callback;
+    it->context = context;
+    it->deadline = Now() + std::max<uint32_t>(delay, 1);
+    it->period = period;
+    it->active = true;
+    ++m_active_jobs;
+
+    const auto id = static_cast<JobId>(it - m_jobs.begin());
+    Insert(id);
+    return id;
+}
+
+constexpr Scheduler::WheelPosition Scheduler::Place(uint32_t current, uint32_t deadline) noexcept
+{
+    // Deadlines beyond the top level go in its furthest slot, and are placed again when they reach it.
+    constexpr uint32_t max_target = max_delay_ticks - (1u << (slot_bits * (wheel_levels - 1)));
+    const uint32_t target = current + std::min(deadline - current, max_target);
+
+    // The level is the first one whose slot size covers every bit that differs from the current tick,
+    // so the slot's start is still ahead of the wheel.
+    const uint32_t differing = target ^ current;
+    uint32_t level = 0;
+    while (level + 1 < wheel_levels && (differing >> (slot_bits * (level + 1))) != 0)
+    {
+        ++level;
+    }
+    const uint32_t shift = slot_bits * level;
+    return { level, static_cast<uint32_t>((target >> shift) & (wheel_slots - 1)), (target >> shift) << shift };
+}
+
+constexpr bool Scheduler::IsWheelValid() noexcept
+{
+    struct Case
+    {
+        uint32_t current;
+        uint32_t delay;
+    };
+
+    // Slot and level edges, the longest delay the wheel holds and ones past it, and the tick counter wrapping.
+    constexpr std::array<Case, 14> cases
+    { {
+        { 0, 1 }, { 0, 63 }, { 0, 64 }, { 63, 1 }, { 62, 3 }, { 100, 4095 }, { 4095, 1 }, { 4000, 4096 },
+        { 12345, max_delay_ticks - 1 }, { 0, max_delay_ticks }, { 7, 1000000 }, { 0xFFFFFFF0, 40 },
+        { 0xFFFFFF00, 300000 }, { 0xFFFC0001, max_delay_ticks - 1 }
+    } };
+
+    for (const auto& test : cases)
+    {
+        const uint32_t deadline = test.current + test.delay;
+        uint32_t now = test.current;
+        uint32_t level = 0;
+        for (size_t moves = 0; ; ++moves)
+        {
+            // A job cascading down can land in the slot the wheel is at, since the finer levels are processed
+            // after the coarser ones in the same tick. A job inserted from the main loop has to be a tick ahead.
+            const auto position = Place(now, deadline);
+            const uint32_t shift = slot_bits * position.level;
+            const uint32_t ahead = position.start - now;
+            if (moves == 16 || (ahead == 0 && position.level >= level) || ahead > (wheel_slots << shift)
+                || ((position.start >> shift) & (wheel_slots - 1)) != position.slot)
+            {
+                return false;
+            }
+
+            now = position.start;
+            level = position.level;
+            if (level == 0 && now == deadline)
+            {
+                break;
+            }
+        }
+    }
+    return true;
+}
+static_assert(Scheduler::IsWheelValid());
+
+void Scheduler::Insert(JobId id) noexcept
+{
+    auto& job = m_jobs[id];
+    const auto [level, slot, start] = Place(m_current, job.deadline);
+
+    auto& head = m_wheel[level][slot];
+    job.level = static_cast<uint8_t>(level);
+    job.slot = static_cast<uint8_t>(slot);
+    job.prev = no_job;
+    job.next = head;
+    if (head != no_job)
+    {
+        m_jobs[head].prev = static_cast<int8_t>(id);
+    }
+    head = static_cast<int8_t>(id);
+    job.queued = true;
+}
+
+void Scheduler::Remove(JobId id) noexcept
+{
+    auto& job = m_jobs[id];
+    if (job.prev != no_job)
+    {
+        m_jobs[job.prev].next = job.next;
+    }
+    else
+    {
+        m_wheel[job.level][job.slot] = job.next;
+    }
+
+    if (job.next != no_job)
+    {
+        m_jobs[job.next].prev = job.prev;
+    }
+    job.queued = false;
+}
+
+void Scheduler::Advance() noexcept
+{
+    // Move jobs down from the coarser levels whose slot starts at this tick, coarsest first so they can
+    // fall through more than one level.
+    for (size_t level = wheel_levels - 1; level > 0; --level)
+    {
+        if ((m_current & ((1u << (slot_bits * level)) - 1)) != 0)
+        {
+            continue;
+        }
+
+        auto& head = m_wheel[level][(m_current >> (slot_bits * level)) & (wheel_slots - 1)];
+        while (head != no_job)
+        {
+            const auto id = static_cast<JobId>(head);
+            Remove(id);
+            Insert(id);
+        }
+    }
+
+    // Jobs are taken off the list one at a time since a job can cancel another one in the same slot.
+    auto& head = m_wheel[0][m_current & (wheel_slots - 1)];
+    while (head != no_job)
+    {
+        const auto id = static_cast<JobId>(head);
+        Remove(id);
+        if (m_jobs[id].deadline == m_current)
+        {
+            Execute(id);
+        }
+        else
+        {
+            Insert(id);
+        }
+    }
+}
+
+void Scheduler::Execute(JobId id) noexcept
+{
+    auto& job = m_jobs[id];
+
+    const auto now = SteadyClock::now().time_since_epoch();
+    const auto now_tick = std::chrono::floor<tick>(now);
+    const auto lateness = tick{ static_cast<uint32_t>(now_tick.count()) - job.deadline } + (now - now_tick);
+    ++job.stats.runs;
+    if (lateness >= tick{ 1 })
+    {
+        ++job.stats.late_runs;
+    }
+    job.stats.max_lateness = std::max(job.stats.max_lateness, std::chrono::duration_cast<SteadyClock::duration>(lateness));
+
+    job.callback(job.context);
+
+    // The job may have cancelled itself, and its entry may even have been reused by a new job.
+    if (!job.active || job.queued)
+    {
+        return;
+    }
+
+    if (job.period == 0)
+    {
+        job.active = false;
+        --m_active_jobs;
+        return;
+    }
+
+    job.deadline += job.period;
+    while (static_cast<int32_t>(job.deadline - m_current) <= 0)
+    {
+        job.deadline += job.period;
+        ++job.stats.skipped_periods;
+    }
+    Insert(id);
+}
+
+std::optional<uint32_t> Scheduler::NextWake() const noexcept
+{
+    if (m_active_jobs == 0)
+    {
+        return std::nullopt;
+    }
+
+    // Either the next occupied slot of the finest level, or the next time a coarser level has to be cascaded.
+    for (uint32_t next = m_current + 1; ; ++next)
+    {
+        if ((next & (wheel_slots - 1)) == 0 || m_wheel[0][next & (wheel_slots - 1)] != no_job)
+        {
+            return next;
+        }
+    }
+}
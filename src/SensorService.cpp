@@ -0,0 +1,62 @@
+#include "SensorService.hpp"
+
+SensorService::SensorService(RHT03& sensor, Executor& executor, const SensorPolicy& policy) noexcept :
+    m_sensor{ sensor }, m_executor{ executor }, m_policy{ policy }, m_last_read{ SteadyClock::now() }
+{
+    m_snapshot.last_status = RHT03Status::MissingEdges;
+    m_snapshot.is_stale = true;
+}
+
+Task SensorService::Run() noexcept
+{
+    while (true)
+    {
+        co_await m_executor.WaitUntil(IsRefreshRequested, this);
+        co_await m_executor.DelayUntil(m_last_read + m_policy.min_interval);
+
+        // Requests made during the read are for data newer than it, so they start another one.
+        m_refresh_requested = false;
+        m_last_read = SteadyClock::now();
+        if (!m_sensor.StartRead())
+        {
+            Update({ RHT03Status::LineBusy, {} });
+            continue;
+        }
+
+        // The start pulse and the frame run from interrupts. A read that is still going by now never will finish.
+        co_await m_executor.Delay(RHT03::read_time);
+        m_sensor.CancelRead();
+        Update(m_sensor.GetResult());
+    }
+}
+
+SensorSnapshot SensorService::Read(std::chrono::milliseconds max_age) noexcept
+{
+    auto snapshot = m_snapshot;
+    snapshot.age = SteadyClock::now() - snapshot.timestamp;
+    snapshot.is_stale = !snapshot.is_valid || snapshot.age > max_age;
+    if (snapshot.is_stale)
+    {
+        RequestRefresh();
+    }
+    return snapshot;
+}
+
+bool SensorService::IsRefreshRequested(void* context) noexcept
+{
+    return static_cast<SensorService*>(context)->m_refresh_requested;
+}
+
+void SensorService::Update(const RHT03Result& result) noexcept
+{
+    // A failed read keeps the last good reading, which ages from when it was taken.
+    m_snapshot.last_status = result.status;
+    if (result.status == RHT03Status::Ok)
+    {
+        m_snapshot.reading = result.reading;
+        m_snapshot.timestamp = m_last_read;
+        m_snapshot.is_valid = true;
+        m_snapshot.is_low_margin = result.margin_us < m_policy.low_margin_us;
+    }
+    ++m_snapshot.sequence;
+}
@@ -1,11 +1,23 @@
 #include "Serial.hpp"
 #include "stm32l4xx_hal.h"
+#include <algorithm>
 #include <cstdarg>
 #include <cstdio>
 #include <cstring>
 
 extern USART_HandleTypeDef husart2;
 
+namespace
+{
+	char async_buffer[100]{};
+
+	// A blocking transmit would fail while a background one is still going.
+	void WaitForTransmit()
+	{
+		while (!IsTransmitDone()) ;
+	}
+}
+
 bool Print(const char* format, ...)
 {
 	char str[100]{};
@@ -18,6 +30,7 @@ bool Print(const char* format, ...)
 		return false;
 	}
 
+	WaitForTransmit();
 	return HAL_USART_Transmit(&husart2, reinterpret_cast<uint8_t*>(str), length, 1000) == HAL_OK;
 }
 
@@ -35,5 +48,33 @@ bool PrintLine(const char* format, ...)
 	str[length++] = '\r';
 	str[length++] = '\n';
 
+	WaitForTransmit();
 	return HAL_USART_Transmit(&husart2, reinterpret_cast<uint8_t*>(str), length, 1000) == HAL_OK;
 }
+
+bool PrintLineAsync(const char* format, ...)
+{
+	if (!IsTransmitDone())
+	{
+		return false;
+	}
+
+	va_list args;
+	va_start(args, format);
+	int length = vsnprintf(async_buffer, sizeof(async_buffer) - 2, format, args);
+	va_end(args);
+	if (length < 0)
+	{
+		return false;
+	}
+	length = std::min<int>(length, sizeof(async_buffer) - 3);
+	async_buffer[length++] = '\r';
+	async_buffer[length++] = '\n';
+
+	return HAL_USART_Transmit_IT(&husart2, reinterpret_cast<uint8_t*>(async_buffer), length) == HAL_OK;
+}
+
+bool IsTransmitDone()
+{
+	return husart2.State != HAL_USART_STATE_BUSY_TX;
+}
@@ -0,0 +1,34 @@
+#include "SteadyClock.hpp"
+#include "stm32l4xx_hal.h"
+
+extern TIM_HandleTypeDef htim2;
+
+namespace
+{
+    volatile uint32_t overflows = 0;
+}
+
+SteadyClock::time_point SteadyClock::now() noexcept
+{
+    while (true)
+    {
+        const uint32_t high = overflows;
+        const uint32_t low = __HAL_TIM_GET_COUNTER(&htim2);
+
+        // The counter wrapped but the interrupt hasn't run yet, because it is blocked by the caller's priority.
+        // A small count means the read was after the wrap.
+        const bool pending = __HAL_TIM_GET_FLAG(&htim2, TIM_FLAG_UPDATE) && low < 0x8000'0000;
+
+        // If the interrupt ran between the reads, the two halves may not match.
+        if (overflows == high)
+        {
+            const uint64_t ticks = (static_cast<uint64_t>(high + (pending ? 1 : 0)) << 32) | low;
+            return time_point{ duration{ static_cast<rep>(ticks) } };
+        }
+    }
+}
+
+void SteadyClock::OnOverflow() noexcept
+{
+    overflows = overflows + 1;
+}
@@ -0,0 +1,107 @@
+#include "Task.hpp"
+#include <algorithm>
+#include <bitset>
+
+namespace
+{
+    struct alignas(std::max_align_t) Block
+    {
+        std::byte storage[TaskArena::block_size];
+    };
+
+    std::array<Block, TaskArena::block_count> blocks;
+    std::bitset<TaskArena::block_count> used_blocks;
+    size_t largest_frame = 0;
+    uint32_t failed_allocations = 0;
+}
+
+void* TaskArena::Allocate(size_t size) noexcept
+{
+    largest_frame = std::max(largest_frame, size);
+    if (size <= block_size)
+    {
+        for (size_t i = 0; i < block_count; ++i)
+        {
+            if (!used_blocks[i])
+            {
+                used_blocks[i] = true;
+                return blocks[i].storage;
+            }
+        }
+    }
+
+    ++failed_allocations;
+    return nullptr;
+}
+
+void TaskArena::Free(void* block) noexcept
+{
+    const auto i = static_cast<size_t>(static_cast<Block*>(block) - blocks.data());
+    used_blocks[i] = false;
+}
+
+size_t TaskArena::LargestFrame() noexcept
+{
+    return largest_frame;
+}
+
+uint32_t TaskArena::FailedAllocations() noexcept
+{
+    return failed_allocations;
+}
+
+bool Executor::Spawn(Task task) noexcept
+{
+    if (!task.IsValid())
+    {
+        return false;
+    }
+
+    // The frame frees itself when the body returns, so the task gives up its handle.
+    auto handle = task.m_handle;
+    task.m_handle = nullptr;
+    handle.resume();
+    return true;
+}
+
+void Executor::Run() noexcept
+{
+    while (true)
+    {
+        m_scheduler.RunPending();
+        ResumeReady();
+        m_scheduler.Idle(HasReadyWaiter, this);
+    }
+}
+
+bool Executor::AddWaiter(std::coroutine_handle<> handle, Scheduler::Condition condition, void* context) noexcept
+{
+    auto it = std::find_if(m_waiters.begin(), m_waiters.end(), [](const Waiter& waiter) { return !waiter.handle; });
+    if (it == m_waiters.end())
+    {
+        return false;
+    }
+
+    *it = { handle, condition, context };
+    return true;
+}
+
+void Executor::ResumeReady() noexcept
+{
+    // The slot is freed before resuming, since the task may wait again straight away.
+    for (auto& waiter : m_waiters)
+    {
+        if (waiter.handle && waiter.condition(waiter.context))
+        {
+            auto handle = waiter.handle;
+            waiter = {};
+            handle.resume();
+        }
+    }
+}
+
+bool Executor::HasReadyWaiter(void* context) noexcept
+{
+    const auto& waiters = static_cast<Executor*>(context)->m_waiters;
+    return std::any_of(waiters.begin(), waiters.end(), [](const Waiter& waiter) { return waiter.handle && waiter.condition(waiter.context); });
+}
@@ -1,28 +1,21 @@
 #include "Time.hpp"
+#include "SteadyClock.hpp"
 #include "stm32l4xx_hal.h"
 
-extern TIM_HandleTypeDef htim2;
-
-uint32_t Timer_100ns()
+void Time_Init()
 {
-	 return __HAL_TIM_GET_COUNTER(&htim2);
+	CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+	DWT->CYCCNT = 0;
+	DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
 }
 
 uint32_t Timer_us()
 {
-	return Timer_100ns() / 10;
-}
-
-void Delay_100ns(uint32_t multiplier)
-{
-	// Timer has a frequency of 10MHz (100ns).
-	__HAL_TIM_SET_COUNTER(&htim2, 0);
-	while (Timer_100ns() < multiplier) ;
+	const auto now = SteadyClock::now().time_since_epoch();
+	return static_cast<uint32_t>(std::chrono::duration_cast<std::chrono::microseconds>(now).count());
 }
 
 void Delay_us(uint32_t delay)
 {
-	// 1us = 1000ns, but we can only delay in increments of 100ns,
-	// hence why we multiply by 10.
-	Delay_100ns(delay * 10);
-}
\ No newline at end of file
+	Delay_cycles(delay * (core_clock_hz / 1'000'000));
+}
@@ -1,41 +1,84 @@
 #include "stm32l4xx_hal.h"
 #include "Pins.hpp"
+#include "HALPorts.hpp"
 #include "LCD_TC1602A.hpp"
 #include "Serial.hpp"
 #include "Time.hpp"
+#include "SteadyClock.hpp"
+#include "Scheduler.hpp"
+#include "Task.hpp"
+#include "PinEdge.hpp"
+#include "RHT03.hpp"
+#include "RHT03Array.hpp"
+#include "SensorService.hpp"
+#include "Format.hpp"
+#include <algorithm>
 #include <array>
-#include <cstdio>
+#include <chrono>
 
+TIM_HandleTypeDef htim1;
 TIM_HandleTypeDef htim2;
+TIM_HandleTypeDef htim6;
+TIM_HandleTypeDef htim15;
+TIM_HandleTypeDef htim16;
+DMA_HandleTypeDef hdma_tim1_ch1;
+DMA_HandleTypeDef hdma_tim1_ch2;
+DMA_HandleTypeDef hdma_tim1_ch3;
+DMA_HandleTypeDef hdma_tim15_up;
+DMA_HandleTypeDef hdma_tim16_ch1;
 USART_HandleTypeDef husart2;
 
+static LCD_TC1602A lcd_tc1602a;
+static RHT03 rht03;
+#ifdef RHT03_ARRAY
+static RHT03Array rht03_array{ rht03_array_pins };
+static_assert(std::all_of(rht03_array_pins.begin(), rht03_array_pins.end(),
+	[](const GPIOPin& pin) { return pin.port == rht03_array_pins.front().port; }), "Sampled through one IDR");
+static_assert(rht03_array_pins.size() <= RHT03Array::max_sensors);
+#endif
+
 static void SystemClock_Config();
 static void MX_GPIO_Init();
+static void MX_DMA_Init();
+static void MX_TIM1_Init();
 static void MX_TIM2_Init();
+static void MX_TIM6_Init();
+#ifdef RHT03_ARRAY
+static void MX_TIM15_Init();
+#endif
+static void MX_TIM16_Init();
 static void MX_USART2_Init();
 
 static void Error_Handler(const char* file, int line);
 
-static void SetTempPinMode(bool input);
-static bool ReadTempPin();
-static void WriteTempPin(bool state);
-static bool WaitForTempPin(bool state, uint32_t timeout_us);
-static uint32_t WaitForTempPinPulse(bool state);
-static bool ReadTempData(float* humidity, float* temp);
+static Executor::ConditionAwaiter LCDReady(Executor& executor);
+static Executor::ConditionAwaiter UartTxDone(Executor& executor);
+static Task DisplayReadings(Executor& executor, SensorService& sensor, LCD<LCD_TC1602A>& lcd);
+static Task SendTelemetry(Executor& executor, SensorService& sensor);
+#ifdef RHT03_ARRAY
+static Task ReadArray(Executor& executor);
+#endif
 
 int main()
 {
 	HAL_Init();
 
 	SystemClock_Config();
+	Time_Init();
 
 	MX_GPIO_Init();
+	MX_DMA_Init();
+	MX_TIM1_Init();
 	MX_TIM2_Init();
+	MX_TIM6_Init();
+#ifdef RHT03_ARRAY
+	MX_TIM15_Init();
+#endif
+	MX_TIM16_Init();
 	MX_USART2_Init();
 
 	HAL_TIM_Base_Start(&htim2);
 
-	LCD_TC1602A lcd_tc1602a;
 	LCD lcd{ lcd_tc1602a };
 
 	LCDInit lcd_init
@@ -55,76 +98,210 @@ int main()
 	lcd.SetSettings(lcd_settings);
 	lcd.ReturnHome();
 
-	static constexpr uint32_t update_interval_ms = 2000;
-	uint32_t last_temp_update = HAL_GetTick();
-	std::array<uint8_t, 32> buffer;
-	auto print_lcd_data = [&](uint8_t row, size_t max_bytes_to_read)
+	// From here on the LCD is driven from the TIM6 interrupt and the main loop only queues commands.
+	lcd_tc1602a.SetAsync(true);
+
+#ifndef LCD_TC1602A_WRITE_ONLY
+	// Reading back a few cells per update catches a corrupted display without doubling the bus time.
+	lcd.SetVerifyPolicy(LCDVerifyPolicy::Sampled, 4);
+#endif
+
+	static Scheduler scheduler;
+	static Executor executor{ scheduler };
+	static SensorService sensor{ rht03, executor };
+#ifdef RHT03_ARRAY
+	constexpr size_t task_count = 4;
+#else
+	constexpr size_t task_count = 3;
+#endif
+	static_assert(task_count <= TaskArena::max_tasks, "TaskArena needs a block for every task, plus the spare");
+	if (!executor.Spawn(sensor.Run()) || !executor.Spawn(DisplayReadings(executor, sensor, lcd)) || !executor.Spawn(SendTelemetry(executor, sensor)))
+	{
+		Error_Handler(__FILE__, __LINE__);
+	}
+#ifdef RHT03_ARRAY
+	if (!executor.Spawn(ReadArray(executor)))
 	{
-		if (!lcd.SetCursor(row, 0))
+		Error_Handler(__FILE__, __LINE__);
+	}
+#endif
+
+	// A frame that outgrew its block already failed to spawn. Report how close the others came, in every build.
+	PrintLine("Task frames: largest %u of %u bytes, %u tasks in %u blocks", static_cast<unsigned>(TaskArena::LargestFrame()),
+		static_cast<unsigned>(TaskArena::block_size), static_cast<unsigned>(task_count), static_cast<unsigned>(TaskArena::block_count));
+	if (TaskArena::LargestFrame() > TaskArena::block_size)
+	{
+		Error_Handler(__FILE__, __LINE__);
+	}
+	executor.Run();
+}
+
+static Executor::ConditionAwaiter LCDReady(Executor& executor)
+{
+	return executor.WaitUntil([](void*) { return !lcd_tc1602a.IsSequenceRunning() && lcd_tc1602a.IsIdle(); });
+}
+
+static Executor::ConditionAwaiter UartTxDone(Executor& executor)
+{
+	return executor.WaitUntil([](void*) { return IsTransmitDone(); });
+}
+
+static Task DisplayReadings(Executor& executor, SensorService& sensor, LCD<LCD_TC1602A>& lcd)
+{
+	uint32_t last_verify_mismatches = 0;
+	uint32_t sequence = 0;
+
+	// Waiting for each update keeps the sensor reading as often as it allows.
+	while (true)
+	{
+		co_await sensor.WaitForUpdate(sequence);
+		const auto snapshot = sensor.Read();
+		sequence = snapshot.sequence;
+
+		if (snapshot.last_status != RHT03Status::Ok)
 		{
-			Error_Handler(__FILE__, __LINE__);
+			const auto timeline = rht03.GetTimeline();
+			co_await UartTxDone(executor);
+			PrintLineAsync("RHT03 read failed: %s in %s. Release %u us, ack %u us, data %u us", ToString(snapshot.last_status),
+				ToString(timeline.last_state), timeline.release_us, timeline.acknowledge_us, timeline.data_us);
+			continue;
+		}
+
+		// A high that came this close to the threshold was nearly read as the other bit.
+		if (snapshot.is_low_margin)
+		{
+			const auto result = rht03.GetResult();
+			co_await UartTxDone(executor);
+			PrintLineAsync("RHT03 bit margin %u us at threshold %u us", result.margin_us, result.threshold_us);
 		}
 
-		auto bytes_read = lcd.Read(std::span<uint8_t>{ buffer }.subspan(0, max_bytes_to_read));
-		buffer[bytes_read] = 0;
+		const auto [humidity, temp] = snapshot.reading;
+		std::array<uint8_t, 32> buffer;
+		{
+			auto length = FormatTo(buffer, "Humidity : ", humidity, "%");
+			auto bytes_drawn = lcd.Draw(0, 0, { buffer.begin(), buffer.begin() + length });
+			if (bytes_drawn != length)
+			{
+				co_await UartTxDone(executor);
+				PrintLineAsync("Drew %u bytes. Expected %u bytes.", static_cast<unsigned>(bytes_drawn), static_cast<unsigned>(length));
+			}
+		}
 
-		PrintLine("Row %d: %s", row, buffer.data());
-	};
-	while (1)
-	{
-		uint32_t now = HAL_GetTick();
-		if (now - last_temp_update > update_interval_ms)
 		{
-			float humidity = 0;
-			float temp = 0;
-			if (ReadTempData(&humidity, &temp))
+			auto length = FormatTo(buffer, "Temp     : ", temp, "C");
+			auto bytes_drawn = lcd.Draw(1, 0, { buffer.begin(), buffer.begin() + length });
+			if (bytes_drawn != length)
 			{
-				if (!lcd.SetCursor(0, 0))
-				{
-					Error_Handler(__FILE__, __LINE__);
-				}
-
-				{
-					auto length = sprintf(reinterpret_cast<char*>(buffer.data()), "Humidity : %.1f%%", humidity);
-					auto bytes_written = lcd.Write({ buffer.begin(), buffer.begin() + length });
-					if (bytes_written != static_cast<size_t>(length))
-					{
-						PrintLine("Wrote %d bytes. Expected %d bytes.", bytes_written, length);
-					}
-
-					print_lcd_data(0, bytes_written);
-				}
-
-				if (!lcd.SetCursor(1, 0))
-				{
-					Error_Handler(__FILE__, __LINE__);
-				}
-
-				{
-					auto length = sprintf(reinterpret_cast<char*>(buffer.data()), "Temp     : %.1fC", temp);
-					auto bytes_written = lcd.Write({ buffer.begin(), buffer.begin() + length });
-					if (bytes_written != static_cast<size_t>(length))
-					{
-						PrintLine("Wrote %d bytes. Expected %d bytes.", bytes_written, length);
-					}
-
-					print_lcd_data(1, bytes_written);
-				}
-
-				// PrintLine(
-				// 	"Humidity    : %.1f%%\r\n"
-				// 	"Temperature : %.1f°C\r\n",
-				// 	humidity, temp
-				// );
+				co_await UartTxDone(executor);
+				PrintLineAsync("Drew %u bytes. Expected %u bytes.", static_cast<unsigned>(bytes_drawn), static_cast<unsigned>(length));
 			}
+		}
 
-			last_temp_update = now;
+		// Only the cells that changed since the last update are sent, as a DMA sequence while this task sleeps. Once
+		// it is done some cells are read back, and any that are wrong go out in a second sequence.
+		for (int pass = 0; pass < 2; ++pass)
+		{
+			if (!lcd.FlushAsync())
+			{
+				lcd.Flush();
+				break;
+			}
+			co_await LCDReady(executor);
+			if (!lcd.CheckDisplay())
+			{
+				break;
+			}
 		}
 
-		HAL_Delay(1);
+		auto verify_stats = lcd.GetVerifyStats();
+		if (verify_stats.mismatches != last_verify_mismatches)
+		{
+			co_await UartTxDone(executor);
+			PrintLineAsync("LCD mismatches: %lu of %lu cells checked", static_cast<unsigned long>(verify_stats.mismatches),
+				static_cast<unsigned long>(verify_stats.cells_checked));
+			last_verify_mismatches = verify_stats.mismatches;
+		}
 	}
 }
 
+static Task SendTelemetry(Executor& executor, SensorService& sensor)
+{
+	static constexpr std::chrono::seconds telemetry_period{ 10 };
+
+	auto next_send = SteadyClock::now();
+	while (true)
+	{
+		next_send += telemetry_period;
+		co_await executor.DelayUntil(next_send);
+
+		// Straight from the cache. Only data older than the policy allows asks for a read.
+		const auto snapshot = sensor.Read();
+		if (!snapshot.is_valid)
+		{
+			continue;
+		}
+
+		std::array<char, 40> line;
+		const uint32_t format_start = Cycles();
+		const auto length = FormatTo(line, "Humidity ", snapshot.reading.humidity, "%, temp ", snapshot.reading.temp, "C");
+		const uint32_t format_cycles = Cycles() - format_start;
+		const auto age = std::chrono::duration_cast<std::chrono::milliseconds>(snapshot.age);
+		co_await UartTxDone(executor);
+#ifdef REPORT_FORMAT_CYCLES
+		// DWT cycles of the FormatTo above, including the two reads of CYCCNT.
+		PrintLineAsync("%.*s, %lu ms old%s%s, formatted in %lu cycles", static_cast<int>(length), line.data(),
+			static_cast<unsigned long>(age.count()), snapshot.is_stale ? ", stale" : "", snapshot.is_low_margin ? ", low margin" : "",
+			static_cast<unsigned long>(format_cycles));
+#else
+		UNUSED(format_cycles);
+		PrintLineAsync("%.*s, %lu ms old%s%s", static_cast<int>(length), line.data(), static_cast<unsigned long>(age.count()),
+			snapshot.is_stale ? ", stale" : "", snapshot.is_low_margin ? ", low margin" : "");
+#endif
+	}
+}
+
+#ifdef RHT03_ARRAY
+static Task ReadArray(Executor& executor)
+{
+	static constexpr std::chrono::seconds read_period{ 10 };
+
+	auto next_read = SteadyClock::now();
+	while (true)
+	{
+		next_read += read_period;
+		co_await executor.DelayUntil(next_read);
+
+		if (!rht03_array.BeginRead())
+		{
+			co_await UartTxDone(executor);
+			PrintLineAsync("RHT03 array: line busy");
+			continue;
+		}
+
+		// Every sensor answers at once, so this is one read's time whatever the number of sensors.
+		co_await executor.Delay(RHT03Array::start_pulse);
+		rht03_array.Release();
+		co_await executor.WaitUntil([](void*) { return !rht03_array.IsSampling(); });
+		rht03_array.Decode();
+
+		for (size_t i = 0; i < rht03_array.Size(); ++i)
+		{
+			const auto result = rht03_array.GetResult(i);
+			co_await UartTxDone(executor);
+			if (result.status != RHT03Status::Ok)
+			{
+				PrintLineAsync("RHT03 %u: %s", static_cast<unsigned>(i), ToString(result.status));
+				continue;
+			}
+
+			std::array<char, 40> line;
+			const auto length = FormatTo(line, "Humidity ", result.reading.humidity, "%, temp ", result.reading.temp, "C");
+			PrintLineAsync("RHT03 %u: %.*s", static_cast<unsigned>(i), static_cast<int>(length), line.data());
+		}
+	}
+}
+#endif
+
 static void SystemClock_Config(void)
 {
 	RCC_OscInitTypeDef RCC_OscInitStruct = {0};
@@ -176,6 +353,78 @@ static void SystemClock_Config(void)
 	}
 }
 
+static void MX_DMA_Init(void)
+{
+	__HAL_RCC_DMA1_CLK_ENABLE();
+
+	// Only port B's channel interrupts, when an LCD sequence is done.
+	HAL_NVIC_SetPriority(DMA1_Channel3_IRQn, 0, 0);
+	HAL_NVIC_EnableIRQ(DMA1_Channel3_IRQn);
+
+	// The RHT03 frame is decoded when its last edge is captured.
+	HAL_NVIC_SetPriority(DMA1_Channel6_IRQn, 0, 0);
+	HAL_NVIC_EnableIRQ(DMA1_Channel6_IRQn);
+
+#ifdef RHT03_ARRAY
+	// The RHT03 array's sampling stops when the buffer is full.
+	HAL_NVIC_SetPriority(DMA1_Channel5_IRQn, 0, 0);
+	HAL_NVIC_EnableIRQ(DMA1_Channel5_IRQn);
+#endif
+}
+
+static void InitTIM1DMA(DMA_HandleTypeDef& hdma, DMA_Channel_TypeDef* channel, uint32_t priority, uint16_t id)
+{
+	hdma.Instance = channel;
+	hdma.Init.Request = DMA_REQUEST_7;
+	hdma.Init.Direction = DMA_MEMORY_TO_PERIPH;
+	hdma.Init.PeriphInc = DMA_PINC_DISABLE;
+	hdma.Init.MemInc = DMA_MINC_ENABLE;
+	hdma.Init.PeriphDataAlignment = DMA_PDATAALIGN_WORD;
+	hdma.Init.MemDataAlignment = DMA_MDATAALIGN_WORD;
+	hdma.Init.Mode = DMA_NORMAL;
+	hdma.Init.Priority = priority;
+	if (HAL_DMA_Init(&hdma) != HAL_OK)
+	{
+		Error_Handler(__FILE__, __LINE__);
+	}
+	__HAL_LINKDMA(&htim1, hdma[id], hdma);
+}
+
+static void MX_TIM1_Init(void)
+{
+	// Paces the LCD's DMA sequences. Each update period is one bus slot, and CC1, CC2 and CC3 match at the start
+	// of it to request a BSRR word for ports A, B and C.
+	htim1.Instance = TIM1;
+	htim1.Init.Prescaler = 0;
+	htim1.Init.CounterMode = TIM_COUNTERMODE_UP;
+	htim1.Init.Period = 80 * lcd_bus_slot_us - 1;
+	htim1.Init.ClockDivision = TIM_CLOCKDIVISION_DIV1;
+	htim1.Init.RepetitionCounter = 0;
+	htim1.Init.AutoReloadPreload = TIM_AUTORELOAD_PRELOAD_DISABLE;
+	if (HAL_TIM_Base_Init(&htim1) != HAL_OK)
+	{
+		Error_Handler(__FILE__, __LINE__);
+	}
+
+	TIM_OC_InitTypeDef sConfigOC = {0};
+	sConfigOC.OCMode = TIM_OCMODE_TIMING;
+	sConfigOC.Pulse = 1;	// See LCD_TC1602A::WriteSequence()
+	sConfigOC.OCPolarity = TIM_OCPOLARITY_HIGH;
+	sConfigOC.OCFastMode = TIM_OCFAST_DISABLE;
+	for (auto channel : { TIM_CHANNEL_1, TIM_CHANNEL_2, TIM_CHANNEL_3 })
+	{
+		if (HAL_TIM_OC_ConfigChannel(&htim1, &sConfigOC, channel) != HAL_OK)
+		{
+			Error_Handler(__FILE__, __LINE__);
+		}
+	}
+
+	// Port B's channel has the lowest priority so it is serviced last in every slot, after every E edge.
+	InitTIM1DMA(hdma_tim1_ch1, DMA1_Channel2, DMA_PRIORITY_MEDIUM, TIM_DMA_ID_CC1);
+	InitTIM1DMA(hdma_tim1_ch2, DMA1_Channel3, DMA_PRIORITY_LOW, TIM_DMA_ID_CC2);
+	InitTIM1DMA(hdma_tim1_ch3, DMA1_Channel7, DMA_PRIORITY_MEDIUM, TIM_DMA_ID_CC3);
+}
+
 static void MX_TIM2_Init(void)
 {
 	TIM_ClockConfigTypeDef sClockSourceConfig = {0};
@@ -202,196 +451,225 @@ static void MX_TIM2_Init(void)
 	{
 		Error_Handler(__FILE__, __LINE__);
 	}
+	// Channel 1 only wakes the scheduler, so it has no output.
+	TIM_OC_InitTypeDef sConfigOC = {0};
+	sConfigOC.OCMode = TIM_OCMODE_TIMING;
+	sConfigOC.Pulse = 0;
+	sConfigOC.OCPolarity = TIM_OCPOLARITY_HIGH;
+	sConfigOC.OCFastMode = TIM_OCFAST_DISABLE;
+	if (HAL_TIM_OC_ConfigChannel(&htim2, &sConfigOC, TIM_CHANNEL_1) != HAL_OK)
+	{
+		Error_Handler(__FILE__, __LINE__);
+	}
+	// The update interrupt extends the counter to 64 bits in SteadyClock.
+	__HAL_TIM_CLEAR_FLAG(&htim2, TIM_FLAG_UPDATE | TIM_FLAG_CC1);
+	__HAL_TIM_ENABLE_IT(&htim2, TIM_IT_UPDATE | TIM_IT_CC1);
 }
 
-static void MX_USART2_Init(void)
+static void MX_TIM6_Init(void)
 {
-	husart2.Instance = USART2;
-	husart2.Init.BaudRate = 115200;
-	husart2.Init.WordLength = USART_WORDLENGTH_8B;
-	husart2.Init.StopBits = USART_STOPBITS_1;
-	husart2.Init.Parity = USART_PARITY_NONE;
-	husart2.Init.Mode = USART_MODE_TX_RX;
-	husart2.Init.CLKPolarity = USART_POLARITY_LOW;
-	husart2.Init.CLKPhase = USART_PHASE_1EDGE;
-	husart2.Init.CLKLastBit = USART_LASTBIT_DISABLE;
-	if (HAL_USART_Init(&husart2) != HAL_OK)
+	// 1 MHz one pulse timer used to pace the asynchronous LCD queue.
+	htim6.Instance = TIM6;
+	htim6.Init.Prescaler = 80-1;
+	htim6.Init.CounterMode = TIM_COUNTERMODE_UP;
+	htim6.Init.Period = 0xFFFF;
+	htim6.Init.AutoReloadPreload = TIM_AUTORELOAD_PRELOAD_DISABLE;
+	if (HAL_TIM_Base_Init(&htim6) != HAL_OK)
 	{
 		Error_Handler(__FILE__, __LINE__);
 	}
+	SET_BIT(htim6.Instance->CR1, TIM_CR1_OPM);
+	__HAL_TIM_CLEAR_FLAG(&htim6, TIM_FLAG_UPDATE);
+	__HAL_TIM_ENABLE_IT(&htim6, TIM_IT_UPDATE);
 }
 
-static void MX_GPIO_Init(void)
+#ifdef RHT03_ARRAY
+static void MX_TIM15_Init(void)
 {
-	GPIO_InitTypeDef GPIO_InitStruct = {0};
-
-	/* GPIO Ports Clock Enable */
-	__HAL_RCC_GPIOC_CLK_ENABLE();
-	__HAL_RCC_GPIOB_CLK_ENABLE();
-	__HAL_RCC_GPIOA_CLK_ENABLE();
-
-	HAL_GPIO_WritePin(GPIOC, LCD_D4_Pin, GPIO_PIN_RESET);
-
-	/*Configure GPIO pin Output Level */
-	HAL_GPIO_WritePin(GPIOB, LCD_D1_Pin|LCD_E_Pin|LCD_D0_Pin|LCD_D5_Pin|LCD_RW_Pin, GPIO_PIN_RESET);
-
-	/*Configure GPIO pin Output Level */
-	HAL_GPIO_WritePin(GPIOA, LCD_RS_Pin|LCD_D3_Pin|LED_Pin|LCD_D7_Pin|LCD_D2_Pin, GPIO_PIN_RESET);
-
-	/*Configure GPIO pin : BTN_Pin */
-	GPIO_InitStruct.Pin = BTN_Pin;
-	GPIO_InitStruct.Mode = GPIO_MODE_INPUT;
-	GPIO_InitStruct.Pull = GPIO_NOPULL;
-	HAL_GPIO_Init(BTN_GPIO_Port, &GPIO_InitStruct);
-	//
-	GPIO_InitStruct.Pin = LCD_D4_Pin;
-	GPIO_InitStruct.Mode = GPIO_MODE_OUTPUT_PP;
-	GPIO_InitStruct.Pull = GPIO_NOPULL;
-	GPIO_InitStruct.Speed = GPIO_SPEED_FREQ_LOW;
-	HAL_GPIO_Init(GPIOC, &GPIO_InitStruct);
-
-	GPIO_InitStruct.Pin = LCD_D1_Pin|LCD_E_Pin|LCD_D0_Pin|LCD_D5_Pin|LCD_RW_Pin;
-	GPIO_InitStruct.Mode = GPIO_MODE_OUTPUT_PP;
-	GPIO_InitStruct.Pull = GPIO_NOPULL;
-	GPIO_InitStruct.Speed = GPIO_SPEED_FREQ_LOW;
-	HAL_GPIO_Init(GPIOB, &GPIO_InitStruct);
-
-	/*Configure GPIO pin : TEMP_DATA_Pin */
-	GPIO_InitStruct.Pin = TEMP_DATA_Pin;
-	GPIO_InitStruct.Mode = GPIO_MODE_INPUT;
-	GPIO_InitStruct.Pull = GPIO_PULLUP;
-	HAL_GPIO_Init(TEMP_DATA_GPIO_Port, &GPIO_InitStruct);
+	// Only paces the RHT03 array's sampling: every update has DMA copy GPIOC->IDR, at 1 MHz.
+	htim15.Instance = TIM15;
+	htim15.Init.Prescaler = 0;
+	htim15.Init.CounterMode = TIM_COUNTERMODE_UP;
+	htim15.Init.Period = 80-1;
+	htim15.Init.ClockDivision = TIM_CLOCKDIVISION_DIV1;
+	htim15.Init.RepetitionCounter = 0;
+	htim15.Init.AutoReloadPreload = TIM_AUTORELOAD_PRELOAD_DISABLE;
+	if (HAL_TIM_Base_Init(&htim15) != HAL_OK)
+	{
+		Error_Handler(__FILE__, __LINE__);
+	}
 
-	GPIO_InitStruct.Pin = LCD_RS_Pin|LCD_D3_Pin|LED_Pin|LCD_D7_Pin|LCD_D2_Pin|LCD_D6_Pin;
-	GPIO_InitStruct.Mode = GPIO_MODE_OUTPUT_PP;
-	GPIO_InitStruct.Pull = GPIO_NOPULL;
-	GPIO_InitStruct.Speed = GPIO_SPEED_FREQ_LOW;
-	HAL_GPIO_Init(GPIOA, &GPIO_InitStruct);
+	// Very high priority, so the LCD's sequences on the other channels can't hold a sample back.
+	hdma_tim15_up.Instance = DMA1_Channel5;
+	hdma_tim15_up.Init.Request = DMA_REQUEST_7;
+	hdma_tim15_up.Init.Direction = DMA_PERIPH_TO_MEMORY;
+	hdma_tim15_up.Init.PeriphInc = DMA_PINC_DISABLE;
+	hdma_tim15_up.Init.MemInc = DMA_MINC_ENABLE;
+	hdma_tim15_up.Init.PeriphDataAlignment = DMA_PDATAALIGN_HALFWORD;
+	hdma_tim15_up.Init.MemDataAlignment = DMA_MDATAALIGN_HALFWORD;
+	hdma_tim15_up.Init.Mode = DMA_NORMAL;
+	hdma_tim15_up.Init.Priority = DMA_PRIORITY_VERY_HIGH;
+	if (HAL_DMA_Init(&hdma_tim15_up) != HAL_OK)
+	{
+		Error_Handler(__FILE__, __LINE__);
+	}
+	__HAL_LINKDMA(&htim15, hdma[TIM_DMA_ID_UPDATE], hdma_tim15_up);
+	hdma_tim15_up.XferCpltCallback = [](DMA_HandleTypeDef*) { rht03_array.OnSamplingComplete(); };
 }
+#endif
 
-static void Error_Handler(const char* file, int line)
+static void MX_TIM16_Init(void)
 {
-	PrintLine("%s:%d", file, line);
+	// Timestamps every edge on TEMP_DATA at 1 us for the RHT03. A frame is about 5 ms, well within the 65 ms wrap.
+	htim16.Instance = TIM16;
+	htim16.Init.Prescaler = 80-1;
+	htim16.Init.CounterMode = TIM_COUNTERMODE_UP;
+	htim16.Init.Period = 0xFFFF;
+	htim16.Init.ClockDivision = TIM_CLOCKDIVISION_DIV1;
+	htim16.Init.RepetitionCounter = 0;
+	htim16.Init.AutoReloadPreload = TIM_AUTORELOAD_PRELOAD_DISABLE;
+	if (HAL_TIM_Base_Init(&htim16) != HAL_OK)
+	{
+		Error_Handler(__FILE__, __LINE__);
+	}
+	if (HAL_TIM_IC_Init(&htim16) != HAL_OK)
+	{
+		Error_Handler(__FILE__, __LINE__);
+	}
 
-	__disable_irq();
-	while (1)
+	// The filter ignores glitches shorter than 100 ns.
+	TIM_IC_InitTypeDef sConfigIC = {0};
+	sConfigIC.ICPolarity = TIM_INPUTCHANNELPOLARITY_BOTHEDGE;
+	sConfigIC.ICSelection = TIM_ICSELECTION_DIRECTTI;
+	sConfigIC.ICPrescaler = TIM_ICPSC_DIV1;
+	sConfigIC.ICFilter = 3;
+	if (HAL_TIM_IC_ConfigChannel(&htim16, &sConfigIC, TIM_CHANNEL_1) != HAL_OK)
+	{
+		Error_Handler(__FILE__, __LINE__);
+	}
+
+	hdma_tim16_ch1.Instance = DMA1_Channel6;
+	hdma_tim16_ch1.Init.Request = DMA_REQUEST_4;
+	hdma_tim16_ch1.Init.Direction = DMA_PERIPH_TO_MEMORY;
+	hdma_tim16_ch1.Init.PeriphInc = DMA_PINC_DISABLE;
+	hdma_tim16_ch1.Init.MemInc = DMA_MINC_ENABLE;
+	hdma_tim16_ch1.Init.PeriphDataAlignment = DMA_PDATAALIGN_HALFWORD;
+	hdma_tim16_ch1.Init.MemDataAlignment = DMA_MDATAALIGN_HALFWORD;
+	hdma_tim16_ch1.Init.Mode = DMA_NORMAL;
+	hdma_tim16_ch1.Init.Priority = DMA_PRIORITY_HIGH;
+	if (HAL_DMA_Init(&hdma_tim16_ch1) != HAL_OK)
 	{
+		Error_Handler(__FILE__, __LINE__);
 	}
+	__HAL_LINKDMA(&htim16, hdma[TIM_DMA_ID_CC1], hdma_tim16_ch1);
 }
 
-static void SetTempPinMode(bool input)
+extern "C" void HAL_TIM_IC_CaptureCallback(TIM_HandleTypeDef* htim)
 {
-	GPIO_InitTypeDef GPIO_InitStruct
+	if (htim->Instance == TIM16)
 	{
-		.Pin = TEMP_DATA_Pin,
-		.Mode = input ? GPIO_MODE_INPUT : GPIO_MODE_OUTPUT_OD,
-		.Pull = input ? GPIO_PULLUP : GPIO_NOPULL,
-		.Speed = GPIO_SPEED_FREQ_LOW
-	};
-	HAL_GPIO_Init(TEMP_DATA_GPIO_Port, &GPIO_InitStruct);
+		rht03.OnCaptureComplete();
+	}
 }
 
-static bool ReadTempPin()
+extern "C" void HAL_GPIO_EXTI_Callback(uint16_t GPIO_Pin)
 {
-	return HAL_GPIO_ReadPin(TEMP_DATA_GPIO_Port, TEMP_DATA_Pin);
+	OnPinEdgeInterrupt(GPIO_Pin);
 }
 
-static void WriteTempPin(bool state)
+extern "C" void HAL_TIM_PeriodElapsedCallback(TIM_HandleTypeDef* htim)
 {
-	HAL_GPIO_WritePin(TEMP_DATA_GPIO_Port, TEMP_DATA_Pin, state ? GPIO_PIN_SET : GPIO_PIN_RESET);
+	if (htim->Instance == TIM2)
+	{
+		SteadyClock::OnOverflow();
+	}
+	else if (htim->Instance == TIM6)
+	{
+		lcd_tc1602a.OnTimerElapsed();
+	}
+	else if (htim->Instance == TIM16)
+	{
+		rht03.OnStartPulseElapsed();
+	}
 }
 
-static bool WaitForTempPin(bool state, uint32_t timeout_us)
+static void MX_USART2_Init(void)
 {
-	uint32_t start = Timer_us();
-	while (true)
+	husart2.Instance = USART2;
+	husart2.Init.BaudRate = 115200;
+	husart2.Init.WordLength = USART_WORDLENGTH_8B;
+	husart2.Init.StopBits = USART_STOPBITS_1;
+	husart2.Init.Parity = USART_PARITY_NONE;
+	husart2.Init.Mode = USART_MODE_TX_RX;
+	husart2.Init.CLKPolarity = USART_POLARITY_LOW;
+	husart2.Init.CLKPhase = USART_PHASE_1EDGE;
+	husart2.Init.CLKLastBit = USART_LASTBIT_DISABLE;
+	if (HAL_USART_Init(&husart2) != HAL_OK)
 	{
-		if (ReadTempPin() == state)
-		{
-			return true;
-		}
-
-		if (Timer_us() - start > timeout_us)
-		{
-			return false;
-		}
+		Error_Handler(__FILE__, __LINE__);
 	}
 }
 
-static uint32_t WaitForTempPinPulse(bool state)
+// Outputs get their level before their mode, so they don't glitch when they start being driven.
+static void InitPin(const GPIOPin& pin, uint32_t mode, uint32_t pull, GPIO_PinState state = GPIO_PIN_RESET, uint32_t alternate = 0)
 {
-	uint32_t start = Timer_us();
-	while (ReadTempPin() == state) ;
-	return Timer_us() - start;
+	auto* port = HALPorts::Regs(pin.port);
+	if (mode != GPIO_MODE_INPUT)
+	{
+		HAL_GPIO_WritePin(port, pin.pin, state);
+	}
+
+	GPIO_InitTypeDef GPIO_InitStruct = {0};
+	GPIO_InitStruct.Pin = pin.pin;
+	GPIO_InitStruct.Mode = mode;
+	GPIO_InitStruct.Pull = pull;
+	GPIO_InitStruct.Speed = GPIO_SPEED_FREQ_LOW;
+	GPIO_InitStruct.Alternate = alternate;
+	HAL_GPIO_Init(port, &GPIO_InitStruct);
 }
 
-struct RHT03Data
+static void MX_GPIO_Init(void)
 {
-	uint16_t humidity;
-	uint16_t temp;
-	uint8_t checksum;
-};
+	/* GPIO Ports Clock Enable */
+	__HAL_RCC_GPIOC_CLK_ENABLE();
+	__HAL_RCC_GPIOB_CLK_ENABLE();
+	__HAL_RCC_GPIOA_CLK_ENABLE();
 
-static bool ReadTempData(float* humidity, float* temp)
-{
-	SetTempPinMode(true);
-	if (!WaitForTempPin(true, 1000))
-	{
-		PrintLine("RHT03 is busy");
-		return false;
-	}
+	InitPin(btn_pin, GPIO_MODE_INPUT, GPIO_NOPULL);
+	InitPin(led_pin, GPIO_MODE_OUTPUT_PP, GPIO_NOPULL);
 
-	// Send request for data
-	SetTempPinMode(false);
-	WriteTempPin(false);
-	HAL_Delay(10);
-	SetTempPinMode(true);
-	Delay_us(40);
-	// Wait for acknowledgement
-	if (WaitForTempPinPulse(false) > 1000 || WaitForTempPinPulse(true) > 1000)
-	//if (!WaitForTempPin(false, 1000) || !WaitForTempPin(true, 1000))	// This doesn't work. Data is off by 1 bit.
+	InitPin(lcd_rs_pin, GPIO_MODE_OUTPUT_PP, GPIO_NOPULL);
+	InitPin(lcd_rw_pin, GPIO_MODE_OUTPUT_PP, GPIO_NOPULL);
+	InitPin(lcd_e_pin, GPIO_MODE_OUTPUT_PP, GPIO_NOPULL);
+	for (const auto& pin : lcd_data_pins)
 	{
-		PrintLine("Failed to receive acknowledgement");
-		return false;
+		InitPin(pin, GPIO_MODE_OUTPUT_PP, GPIO_NOPULL);
 	}
 
-	// Read the data
-	constexpr size_t num_bits = 40;
-	std::array<uint16_t, num_bits> low_times, high_times;
-	for (size_t i = 0; i < num_bits; ++i)
-	{
-		low_times[i] = WaitForTempPinPulse(false);
-		high_times[i] = WaitForTempPinPulse(true);
-	}
+	// TIM16_CH1. RHT03 switches it to an output for the start pulse, where the low output level pulls the line down,
+	// and the pull-up holds the line between reads.
+	InitPin(temp_data_pin, GPIO_MODE_AF_OD, GPIO_PULLUP, GPIO_PIN_RESET, GPIO_AF14_TIM16);
 
-	RHT03Data data{};
-	uint8_t bytes[sizeof(data)]{};
-	for (size_t i = 0; i < num_bits; ++i)
+#ifdef RHT03_ARRAY
+	// Open drain and released, so IDR reads each line and one BSRR store pulls them all low together.
+	for (const auto& pin : rht03_array_pins)
 	{
-		//PrintLine("%2u, %3u, %3u", i, low_times[i], high_times[i]);
-	    bytes[i / 8] <<= 1;
-	    if (high_times[i] > 50)
-	    {
-	    	bytes[i / 8] |= 1;
-	    }
+		InitPin(pin, GPIO_MODE_OUTPUT_OD, GPIO_PULLUP, GPIO_PIN_SET);
 	}
-	data.humidity = bytes[0] << 8 | bytes[1];
-	data.temp = bytes[2] << 8 | bytes[3];
-	data.checksum = bytes[4];
+#endif
+
+	// Edges on TEMP_DATA are armed on demand through PinEdge.
+	static_assert(IsPinEdgeLine(temp_data_pin));
+	HAL_NVIC_SetPriority(EXTI9_5_IRQn, 0, 0);
+	HAL_NVIC_EnableIRQ(EXTI9_5_IRQn);
+}
 
-	//PrintLine("humidity data: %u", data.humidity);
-	//PrintLine("temp data: %u", data.temp);
-	//PrintLine("checksum data: %u", data.checksum);
+static void Error_Handler(const char* file, int line)
+{
+	PrintLine("%s:%d", file, line);
 
-	uint8_t sum = bytes[0] + bytes[1] + bytes[2] + bytes[3];
-	if (sum != data.checksum)
+	__disable_irq();
+	while (1)
 	{
-		PrintLine("Checksum mismatch: %u != %u", sum, data.checksum);
-		return false;
 	}
-
-	*humidity = data.humidity / 10.0;
-	*temp = data.temp / 10.0;
-
-	return true;
-}
\ No newline at end of file
+}
@@ -0,0 +1,26 @@
+#pragma once
+#include <cstdio>
+
+// Just enough for the host tests. A failed check prints where it is and the test carries on, so one run shows every
+// failure. Main returns CheckResult().
+inline int check_failures = 0;
+
+#define CHECK(...) \
+    do \
+    { \
+        if (!(__VA_ARGS__)) \
+        { \
+            std::printf("%s:%d: CHECK(%s) failed\n", __FILE__, __LINE__, #__VA_ARGS__); \
+            ++check_failures; \
+        } \
+    } while (false)
+
+[[nodiscard]] inline int CheckResult() noexcept
+{
+    if (check_failures != 0)
+    {
+        std::printf("%d checks failed\n", check_failures);
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,60 @@
+#pragma once
+#include "GPIOPin.hpp"
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+// Ports for IOPin and ParallelBus on host. BSRR stores are applied to ODR the way the hardware does, a reset bit
+// losing to a set bit, and counted. IDR reads whatever the test puts there, e.g. ODR for a loopback.
+struct FakeBSRR
+{
+    uint32_t odr = 0;
+    uint32_t stores = 0;
+
+    FakeBSRR& operator=(uint32_t word) noexcept
+    {
+        odr = ((odr & ~(word >> 16)) | word) & 0xFFFF;
+        ++stores;
+        return *this;
+    }
+};
+
+struct FakeGPIO
+{
+    uint32_t MODER = 0;
+    uint32_t IDR = 0;
+    FakeBSRR BSRR;
+};
+
+struct FakePorts
+{
+    static inline std::array<FakeGPIO, gpio_port_count> ports{};
+
+    static FakeGPIO* Regs(GPIOPort port) noexcept
+    {
+        return &ports[static_cast<size_t>(port)];
+    }
+
+    static void SetModes(FakeGPIO* gpio, uint32_t mask, uint32_t mode) noexcept
+    {
+        gpio->MODER = (gpio->MODER & ~mask) | mode;
+    }
+
+    static void Reset(uint32_t odr, uint32_t moder) noexcept
+    {
+        for (auto& port : ports)
+        {
+            port = {};
+            port.BSRR.odr = odr;
+            port.MODER = moder;
+        }
+    }
+
+    static void LoopBack() noexcept
+    {
+        for (auto& port : ports)
+        {
+            port.IDR = port.BSRR.odr;
+        }
+    }
+};
@@ -0,0 +1,116 @@
+#include "Check.hpp"
+#include "LCDBus.hpp"
+#include <vector>
+
+namespace
+{
+    struct Expansion
+    {
+        std::array<std::vector<uint32_t>, gpio_port_count> buffers;
+        size_t slot_count = 0;
+    };
+
+    Expansion Expand(std::span<const LCDBusWrite> writes, size_t buffer_slots, const GPIOPin& e_pin)
+    {
+        Expansion expansion;
+        std::array<std::span<uint32_t>, gpio_port_count> out{};
+        for (size_t port = 0; port < gpio_port_count; ++port)
+        {
+            // Filled with a marker so slots the expansion should have written, but didn't, show up.
+            expansion.buffers[port].assign(buffer_slots, 0xDEADBEEF);
+            out[port] = expansion.buffers[port];
+        }
+        expansion.slot_count = ExpandBusWrites(writes, out, e_pin);
+        return expansion;
+    }
+
+    // Every slot holds what it should: RS and data, then E rising, then E falling, then nothing.
+    void CheckSlots(std::span<const LCDBusWrite> writes, const GPIOPin& e_pin)
+    {
+        const auto expansion = Expand(writes, LCDBusSlots(writes.size()), e_pin);
+        CHECK(expansion.slot_count == LCDBusSlots(writes.size()));
+
+        const auto rs_port = static_cast<size_t>(lcd_rs_pin.port);
+        const auto e_port = static_cast<size_t>(e_pin.port);
+        for (size_t slot = 0; slot < expansion.slot_count; ++slot)
+        {
+            const size_t write = slot / lcd_bus_slots_per_write;
+            const size_t phase = slot % lcd_bus_slots_per_write;
+            for (size_t port = 0; port < gpio_port_count; ++port)
+            {
+                uint32_t expected = 0;
+                if (write < writes.size() && phase == 0)
+                {
+                    expected = bsrr_table[writes[write].value][port] | (port == rs_port ? MakePinWord(lcd_rs_pin, writes[write].is_data) : 0u);
+                }
+                else if (write < writes.size() && port == e_port && (phase == 1 || phase == 2))
+                {
+                    expected = MakePinWord(e_pin, phase == 1);
+                }
+                CHECK(expansion.buffers[port][slot] == expected);
+            }
+        }
+    }
+
+    // The time from each E fall to the next E rise, or to the end of the sequence, covers the write time.
+    void CheckSpacing(std::span<const LCDBusWrite> writes)
+    {
+        const auto expansion = Expand(writes, LCDBusSlots(writes.size()), lcd_e_pin);
+        const auto& e_words = expansion.buffers[static_cast<size_t>(lcd_e_pin.port)];
+
+        size_t rises = 0;
+        size_t falls = 0;
+        size_t last_fall = 0;
+        for (size_t slot = 0; slot < expansion.slot_count; ++slot)
+        {
+            if (e_words[slot] == MakePinWord(lcd_e_pin, true))
+            {
+                CHECK(falls == 0 || (slot - last_fall) * lcd_bus_slot_us >= lcd_bus_write_time_us);
+                ++rises;
+            }
+            else if (e_words[slot] == MakePinWord(lcd_e_pin, false))
+            {
+                last_fall = slot;
+                ++falls;
+            }
+        }
+        CHECK(rises == writes.size() && falls == writes.size());
+        CHECK((expansion.slot_count - 1 - last_fall) * lcd_bus_slot_us >= lcd_bus_write_time_us);
+    }
+
+    // Buffers too small for the idle slots are rejected and left alone, while larger ones are only written up to
+    // the slot count.
+    void CheckBufferSizes(std::span<const LCDBusWrite> writes)
+    {
+        const auto slot_count = LCDBusSlots(writes.size());
+        const auto short_expansion = Expand(writes, slot_count - 1, lcd_e_pin);
+        CHECK(short_expansion.slot_count == 0);
+        for (const auto& buffer : short_expansion.buffers)
+        {
+            CHECK(std::all_of(buffer.begin(), buffer.end(), [](uint32_t word) { return word == 0xDEADBEEF; }));
+        }
+
+        const auto long_expansion = Expand(writes, slot_count + 4, lcd_e_pin);
+        CHECK(long_expansion.slot_count == slot_count);
+        for (const auto& buffer : long_expansion.buffers)
+        {
+            CHECK(std::all_of(buffer.begin() + slot_count, buffer.end(), [](uint32_t word) { return word == 0xDEADBEEF; }));
+        }
+    }
+}
+
+int main()
+{
+    constexpr std::array<LCDBusWrite, 3> writes{ { { true, 0xA5 }, { false, 0xC3 }, { true, 0x5A } } };
+    constexpr std::array<LCDBusWrite, 1> single{ { { false, 0x80 } } };
+
+    CheckSlots(writes, lcd_e_pin);
+    CheckSlots(single, lcd_e_pin);
+    // Another panel's E pin, as LCDPanelGroup uses.
+    CheckSlots(writes, GPIOPin{ GPIOPort::C, 1u << 8 });
+    CheckSlots({}, lcd_e_pin);
+    CheckSpacing(writes);
+    CheckSpacing(single);
+    CheckBufferSizes(writes);
+    return CheckResult();
+}
@@ -0,0 +1,43 @@
+#include "Check.hpp"
+#include "LCDBus.hpp"
+
+namespace
+{
+    struct Wire
+    {
+        GPIOPort port;
+        uint32_t line;
+    };
+
+    // The LCD's D0 - D7 as wired, written out from the board rather than taken from Pins.hpp.
+#ifdef LCD_DATA_PINS_PC0_7
+    constexpr std::array<Wire, 8> wiring{ { { GPIOPort::C, 0 }, { GPIOPort::C, 1 }, { GPIOPort::C, 2 }, { GPIOPort::C, 3 },
+        { GPIOPort::C, 4 }, { GPIOPort::C, 5 }, { GPIOPort::C, 6 }, { GPIOPort::C, 7 } } };
+#else
+    // Arduino headers D5 - D12, see the README.
+    constexpr std::array<Wire, 8> wiring{ { { GPIOPort::B, 4 }, { GPIOPort::B, 10 }, { GPIOPort::A, 8 }, { GPIOPort::A, 9 },
+        { GPIOPort::C, 7 }, { GPIOPort::B, 6 }, { GPIOPort::A, 7 }, { GPIOPort::A, 6 } } };
+#endif
+
+    // Each entry sets the lines of the 1 bits, resets the lines of the 0 bits, and leaves every other line alone.
+    void CheckTable()
+    {
+        for (uint32_t value = 0; value < 256; ++value)
+        {
+            BSRRWords expected{};
+            for (size_t bit = 0; bit < wiring.size(); ++bit)
+            {
+                const auto line = wiring[bit].line + (((value >> bit) & 1) != 0 ? 0 : 16);
+                expected[static_cast<size_t>(wiring[bit].port)] |= 1u << line;
+            }
+            CHECK(bsrr_table[value] == expected);
+        }
+        CHECK(LCDDataBus::IsValid());
+    }
+}
+
+int main()
+{
+    CheckTable();
+    return CheckResult();
+}
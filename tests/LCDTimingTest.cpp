@@ -0,0 +1,82 @@
+#include "Check.hpp"
+#include "LCDTiming.hpp"
+
+namespace
+{
+    constexpr size_t Index(LCDCommandClass command_class)
+    {
+        return static_cast<size_t>(command_class);
+    }
+
+    // The datasheet's times at fosc = 270 kHz, with data reads and writes including tADD.
+    void CheckNominalTimes()
+    {
+        const auto times = LCDExecutionTimes(0);
+        CHECK(times[Index(LCDCommandClass::ClearDisplay)] == 1520);
+        CHECK(times[Index(LCDCommandClass::ReturnHome)] == 1520);
+        for (auto command_class : { LCDCommandClass::EntryMode, LCDCommandClass::DisplayControl, LCDCommandClass::CursorDisplayShift,
+            LCDCommandClass::Function, LCDCommandClass::CGRAMAddress, LCDCommandClass::DDRAMAddress })
+        {
+            CHECK(times[Index(command_class)] == 37);
+        }
+        CHECK(times[Index(LCDCommandClass::DataWrite)] == lcd_data_write_time_us);
+        CHECK(times[Index(LCDCommandClass::DataRead)] == lcd_data_write_time_us);
+        CHECK(lcd_data_write_time_us == 37 + 4);
+    }
+
+    // Every time grows by at least the margin and by less than 1 us more, and still fits TIM6's 16 bit counter.
+    void CheckMargins()
+    {
+        const auto nominal = LCDExecutionTimes(0);
+        for (uint32_t margin = 0; margin <= 100; ++margin)
+        {
+            const auto times = LCDExecutionTimes(margin);
+            for (size_t i = 0; i < times.size(); ++i)
+            {
+                CHECK(times[i] * 100u >= nominal[i] * (100 + margin));
+                CHECK((times[i] - 1u) * 100u < nominal[i] * (100 + margin));
+                CHECK(times[i] < 0xFFFF);
+            }
+        }
+
+        // The default write only margin, as in the docs.
+        const auto times = LCDExecutionTimes(25);
+        CHECK(times[Index(LCDCommandClass::ClearDisplay)] == 1900);
+        CHECK(times[Index(LCDCommandClass::EntryMode)] == 47);
+        CHECK(times[Index(LCDCommandClass::DataWrite)] == 52);
+    }
+
+    // Every instruction byte lands in the class of its highest set bit, and data is always a data write.
+    void CheckCommandClasses()
+    {
+        CHECK(LCDCommandClassOf(false, 0x01) == LCDCommandClass::ClearDisplay);
+        CHECK(LCDCommandClassOf(false, 0x02) == LCDCommandClass::ReturnHome);
+        CHECK(LCDCommandClassOf(false, 0x03) == LCDCommandClass::ReturnHome);
+        CHECK(LCDCommandClassOf(false, 0x06) == LCDCommandClass::EntryMode);
+        CHECK(LCDCommandClassOf(false, 0x0C) == LCDCommandClass::DisplayControl);
+        CHECK(LCDCommandClassOf(false, 0x18) == LCDCommandClass::CursorDisplayShift);
+        CHECK(LCDCommandClassOf(false, 0x38) == LCDCommandClass::Function);
+        CHECK(LCDCommandClassOf(false, 0x7F) == LCDCommandClass::CGRAMAddress);
+        CHECK(LCDCommandClassOf(false, 0xC0) == LCDCommandClass::DDRAMAddress);
+
+        for (uint32_t value = 0; value < 256; ++value)
+        {
+            CHECK(LCDCommandClassOf(true, static_cast<uint8_t>(value)) == LCDCommandClass::DataWrite);
+
+            size_t highest_bit = 0;
+            for (size_t bit = 0; bit < 8; ++bit)
+            {
+                highest_bit = ((value >> bit) & 1) != 0 ? bit : highest_bit;
+            }
+            CHECK(Index(LCDCommandClassOf(false, static_cast<uint8_t>(value))) == highest_bit);
+        }
+    }
+}
+
+int main()
+{
+    CheckNominalTimes();
+    CheckMargins();
+    CheckCommandClasses();
+    return CheckResult();
+}
@@ -0,0 +1,98 @@
+#include "RHT03Captures.hpp"
+#include <cstdlib>
+
+// Makes up RHT03 captures, in the format of RHT03Captures.hpp, for the classifier benchmark when there are no
+// recordings of a misbehaving sensor. Each frame has random bytes with a valid checksum, and its own clock error of
+// up to clock_percent either way and stretch of every high of up to stretch_us. Every duration then gets up to
+// jitter_us either way. The frames only depend on the arguments.
+//   MakeRHT03Captures clock_percent jitter_us stretch_us count [seed]
+
+namespace
+{
+    struct Sweep
+    {
+        int32_t clock_percent = 0;
+        int32_t jitter_us = 0;
+        int32_t stretch_us = 0;
+    };
+
+    class Random
+    {
+    public:
+        explicit Random(uint32_t seed) noexcept : m_state{ seed }
+        {
+        }
+
+        // 0 to range, both included.
+        uint32_t operator()(uint32_t range) noexcept
+        {
+            m_state = m_state * 1664525u + 1013904223u;
+            return (m_state >> 16) % (range + 1);
+        }
+
+        int32_t Spread(int32_t amount) noexcept
+        {
+            return static_cast<int32_t>((*this)(static_cast<uint32_t>(2 * amount))) - amount;
+        }
+
+    private:
+        uint32_t m_state;
+    };
+
+    RHT03Capture MakeCapture(const Sweep& sweep, Random& random)
+    {
+        // 0 - 100 % and -40 - 80 C, the sensor's range.
+        const auto humidity = static_cast<int32_t>(random(1000));
+        const auto temp = static_cast<int32_t>(random(1200)) - 400;
+        const auto temp_bits = static_cast<uint32_t>(temp < 0 ? 0x8000 - temp : temp);
+
+        RHT03Capture capture;
+        auto& bytes = capture.bytes;
+        bytes = { static_cast<uint8_t>(humidity >> 8), static_cast<uint8_t>(humidity), static_cast<uint8_t>(temp_bits >> 8),
+            static_cast<uint8_t>(temp_bits) };
+        bytes[4] = static_cast<uint8_t>(bytes[0] + bytes[1] + bytes[2] + bytes[3]);
+
+        const int32_t clock = 100 + random.Spread(sweep.clock_percent);
+        const auto stretch = static_cast<int32_t>(random(static_cast<uint32_t>(sweep.stretch_us)));
+        uint16_t time = 0;
+        const auto add = [&](int32_t nominal_us, int32_t extra_us)
+        {
+            capture.edges.push_back(time);
+            time = static_cast<uint16_t>(time + nominal_us * clock / 100 + extra_us + random.Spread(sweep.jitter_us));
+        };
+
+        add(30, 0);
+        add(80, 0);
+        add(80, 0);
+        for (size_t bit = 0; bit < rht03_frame_bits; ++bit)
+        {
+            add(50, 0);
+            add(((bytes[bit / 8] >> (7 - bit % 8)) & 1) != 0 ? 70 : 27, stretch);
+        }
+        add(50, 0);
+        add(0, 0);
+        return capture;
+    }
+}
+
+int main(int argc, char** argv)
+{
+    if (argc != 5 && argc != 6)
+    {
+        std::printf("Usage: %s clock_percent jitter_us stretch_us count [seed]\n", argv[0]);
+        return 1;
+    }
+
+    const Sweep sweep{ std::atoi(argv[1]), std::atoi(argv[2]), std::atoi(argv[3]) };
+    const auto count = std::atoi(argv[4]);
+    const auto seed = argc == 6 ? static_cast<uint32_t>(std::atol(argv[5])) : 1u;
+
+    std::printf("# Made up by MakeRHT03Captures %s %s %s %s %u: clock error up to %d %%, jitter up to %d us, highs stretched up to %d us\n",
+        argv[1], argv[2], argv[3], argv[4], static_cast<unsigned>(seed), sweep.clock_percent, sweep.jitter_us, sweep.stretch_us);
+    Random random{ seed };
+    for (int frame = 0; frame < count; ++frame)
+    {
+        WriteRHT03Capture(stdout, MakeCapture(sweep, random));
+    }
+    return 0;
+}
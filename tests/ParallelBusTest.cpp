@@ -0,0 +1,143 @@
+#include "Check.hpp"
+#include "FakePorts.hpp"
+#include "Pins.hpp"
+#include <bit>
+
+namespace
+{
+    // Pins spread over every port in no particular order, and pins that make up one contiguous byte.
+    constexpr std::array<GPIOPin, 8> scattered_pins
+    { {
+        { GPIOPort::B, 1u << 4 },
+        { GPIOPort::B, 1u << 10 },
+        { GPIOPort::A, 1u << 8 },
+        { GPIOPort::A, 1u << 9 },
+        { GPIOPort::C, 1u << 7 },
+        { GPIOPort::B, 1u << 6 },
+        { GPIOPort::A, 1u << 7 },
+        { GPIOPort::A, 1u << 6 }
+    } };
+    constexpr std::array<GPIOPin, 8> contiguous_pins
+    { {
+        { GPIOPort::C, 1u << 3 },
+        { GPIOPort::C, 1u << 4 },
+        { GPIOPort::C, 1u << 5 },
+        { GPIOPort::C, 1u << 6 },
+        { GPIOPort::C, 1u << 7 },
+        { GPIOPort::C, 1u << 8 },
+        { GPIOPort::C, 1u << 9 },
+        { GPIOPort::C, 1u << 10 }
+    } };
+
+    uint32_t PortMask(const std::array<GPIOPin, 8>& pins, GPIOPort port)
+    {
+        uint32_t mask = 0;
+        for (const auto& pin : pins)
+        {
+            mask |= pin.port == port ? pin.pin : 0u;
+        }
+        return mask;
+    }
+
+    // Every value goes out and reads back through a loopback, from every pin high and from every pin low. Only
+    // the bus's pins change, with one store per port the bus uses.
+    template<const auto& Pins>
+    void CheckWriteRead()
+    {
+        using Bus = ParallelBus<Pins, FakePorts>;
+        size_t ports_used = 0;
+        for (size_t port = 0; port < gpio_port_count; ++port)
+        {
+            ports_used += PortMask(Pins, static_cast<GPIOPort>(port)) != 0 ? 1 : 0;
+        }
+
+        for (uint32_t initial : { 0x0000u, 0xFFFFu })
+        {
+            for (uint32_t value = 0; value < 256; ++value)
+            {
+                FakePorts::Reset(initial, 0);
+                Bus::Write(static_cast<uint8_t>(value));
+
+                uint32_t stores = 0;
+                for (size_t port = 0; port < gpio_port_count; ++port)
+                {
+                    const auto& gpio = FakePorts::ports[port];
+                    const auto mask = PortMask(Pins, static_cast<GPIOPort>(port));
+                    CHECK(((gpio.BSRR.odr ^ initial) & ~mask) == 0);
+                    stores += gpio.BSRR.stores;
+                }
+                CHECK(stores == ports_used);
+
+                for (size_t i = 0; i < Pins.size(); ++i)
+                {
+                    const bool level = (FakePorts::ports[static_cast<size_t>(Pins[i].port)].BSRR.odr & Pins[i].pin) != 0;
+                    CHECK(level == (((value >> i) & 1) != 0));
+                }
+
+                FakePorts::LoopBack();
+                CHECK(Bus::Read() == value);
+            }
+        }
+    }
+
+    // Only the bus's two MODER bits per pin change, to 01 for output and 00 for input.
+    template<const auto& Pins>
+    void CheckSetOutput()
+    {
+        using Bus = ParallelBus<Pins, FakePorts>;
+        for (uint32_t initial : { 0x00000000u, 0xFFFFFFFFu })
+        {
+            for (bool is_output : { true, false })
+            {
+                FakePorts::Reset(0, initial);
+                Bus::SetOutput(is_output);
+                for (size_t port = 0; port < gpio_port_count; ++port)
+                {
+                    uint32_t mask = 0;
+                    uint32_t expected = 0;
+                    for (const auto& pin : Pins)
+                    {
+                        if (static_cast<size_t>(pin.port) == port)
+                        {
+                            const auto shift = 2 * std::countr_zero(pin.pin);
+                            mask |= 0b11u << shift;
+                            expected |= (is_output ? 0b01u : 0b00u) << shift;
+                        }
+                    }
+                    const auto moder = FakePorts::ports[port].MODER;
+                    CHECK((moder & mask) == expected);
+                    CHECK((moder & ~mask) == (initial & ~mask));
+                }
+            }
+        }
+    }
+
+    void CheckIOPin()
+    {
+        FakePorts::Reset(0, 0);
+        IOPin<temp_data_pin, FakePorts>::Write(true);
+        CHECK(FakePorts::ports[static_cast<size_t>(temp_data_pin.port)].BSRR.odr == temp_data_pin.pin);
+        IOPin<temp_data_pin, FakePorts>::Write(false);
+        CHECK(FakePorts::ports[static_cast<size_t>(temp_data_pin.port)].BSRR.odr == 0);
+
+        FakePorts::ports[static_cast<size_t>(temp_data_pin.port)].IDR = ~static_cast<uint32_t>(temp_data_pin.pin);
+        CHECK(!IOPin<temp_data_pin, FakePorts>::Read());
+        FakePorts::ports[static_cast<size_t>(temp_data_pin.port)].IDR = temp_data_pin.pin;
+        CHECK(IOPin<temp_data_pin, FakePorts>::Read());
+    }
+}
+
+int main()
+{
+    static_assert(!ParallelBus<scattered_pins, FakePorts>::is_contiguous);
+    static_assert(ParallelBus<contiguous_pins, FakePorts>::is_contiguous);
+
+    CheckWriteRead<scattered_pins>();
+    CheckWriteRead<contiguous_pins>();
+    CheckWriteRead<lcd_data_pins>();
+    CheckSetOutput<scattered_pins>();
+    CheckSetOutput<contiguous_pins>();
+    CheckSetOutput<lcd_data_pins>();
+    CheckIOPin();
+    return CheckResult();
+}
@@ -0,0 +1,85 @@
+#include "RHT03Captures.hpp"
+#include <chrono>
+
+// Decodes every frame of the capture files given with each classifier, and reports how many it got wrong and how
+// long a decode takes. A frame is wrong unless it decodes Ok to the bytes it was captured with.
+//   RHT03Benchmark captures...
+
+namespace
+{
+    struct Classifier
+    {
+        RHT03BitClassifier classifier;
+        const char* name;
+    };
+
+    constexpr std::array<Classifier, 3> classifiers{ { { RHT03BitClassifier::FixedThreshold, "FixedThreshold" },
+        { RHT03BitClassifier::LowRatio, "LowRatio" }, { RHT03BitClassifier::TwoCluster, "TwoCluster" } } };
+
+    // Decodes for at least this long, so the timer's resolution doesn't matter.
+    constexpr std::chrono::milliseconds min_timed{ 50 };
+
+    bool IsDecoded(const RHT03Capture& capture, RHT03BitClassifier classifier)
+    {
+        const auto& bytes = capture.bytes;
+        const int32_t humidity = bytes[0] << 8 | bytes[1];
+        const int32_t temp_magnitude = (bytes[2] & 0x7F) << 8 | bytes[3];
+        const int32_t temp = (bytes[2] & 0x80) != 0 ? -temp_magnitude : temp_magnitude;
+
+        const auto result = DecodeRHT03(capture.edges, classifier);
+        return result.status == RHT03Status::Ok && result.reading.humidity.Raw() == humidity && result.reading.temp.Raw() == temp;
+    }
+
+    double NanosecondsPerDecode(const std::vector<RHT03Capture>& captures, RHT03BitClassifier classifier)
+    {
+        using Clock = std::chrono::steady_clock;
+        volatile uint16_t sink = 0;
+        size_t decodes = 0;
+        const auto start = Clock::now();
+        auto elapsed = Clock::duration{};
+        while (elapsed < min_timed)
+        {
+            for (const auto& capture : captures)
+            {
+                sink = static_cast<uint16_t>(sink + DecodeRHT03(capture.edges, classifier).threshold_us);
+            }
+            decodes += captures.size();
+            elapsed = Clock::now() - start;
+        }
+        return std::chrono::duration<double, std::nano>(elapsed).count() / static_cast<double>(decodes);
+    }
+}
+
+int main(int argc, char** argv)
+{
+    if (argc < 2)
+    {
+        std::printf("Usage: %s captures...\n", argv[0]);
+        return 1;
+    }
+
+    std::printf("%-24s %-16s %8s %8s %10s\n", "capture", "classifier", "errors", "rate", "ns/decode");
+    for (int arg = 1; arg < argc; ++arg)
+    {
+        std::vector<RHT03Capture> captures;
+        if (!ReadRHT03Captures(argv[arg], captures) || captures.empty())
+        {
+            std::printf("%s: no captures\n", argv[arg]);
+            return 1;
+        }
+
+        std::string name = argv[arg];
+        name = name.substr(name.find_last_of('/') + 1);
+        for (const auto& [classifier, classifier_name] : classifiers)
+        {
+            size_t errors = 0;
+            for (const auto& capture : captures)
+            {
+                errors += IsDecoded(capture, classifier) ? 0 : 1;
+            }
+            std::printf("%-24s %-16s %4zu/%-3zu %7.1f%% %10.0f\n", name.c_str(), classifier_name, errors, captures.size(),
+                100.0 * static_cast<double>(errors) / static_cast<double>(captures.size()), NanosecondsPerDecode(captures, classifier));
+        }
+    }
+    return 0;
+}
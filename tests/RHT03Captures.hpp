@@ -0,0 +1,88 @@
+#pragma once
+#include "RHT03Decoder.hpp"
+#include <cstdio>
+#include <string>
+#include <vector>
+
+// Captured RHT03 frames, one per line of a text file: the five bytes the sensor sent, in hex, then the time in us
+// of every edge the capture stored, from the 16 bit counter, starting with the host releasing the line. Lines
+// starting with # are comments.
+struct RHT03Capture
+{
+    std::array<uint8_t, rht03_frame_bytes> bytes{};
+    std::vector<uint16_t> edges;
+};
+
+// Returns false, with a message, if the file can't be read or a line can't be parsed.
+[[nodiscard]] inline bool ReadRHT03Captures(const char* path, std::vector<RHT03Capture>& captures)
+{
+    auto* file = std::fopen(path, "r");
+    if (file == nullptr)
+    {
+        std::printf("%s: can't open\n", path);
+        return false;
+    }
+
+    bool is_ok = true;
+    size_t line_number = 0;
+    std::string line;
+    for (int c = std::fgetc(file); c != EOF || !line.empty(); c = std::fgetc(file))
+    {
+        if (c != '\n' && c != EOF)
+        {
+            line += static_cast<char>(c);
+            continue;
+        }
+
+        ++line_number;
+        if (!line.empty() && line[0] != '#')
+        {
+            RHT03Capture capture;
+            const char* next = line.c_str();
+            int length = 0;
+            for (auto& byte : capture.bytes)
+            {
+                unsigned value = 0;
+                is_ok = is_ok && std::sscanf(next, "%2x%n", &value, &length) == 1;
+                byte = static_cast<uint8_t>(value);
+                next += is_ok ? length : 0;
+            }
+
+            unsigned edge = 0;
+            while (is_ok && std::sscanf(next, "%u%n", &edge, &length) == 1)
+            {
+                is_ok = edge <= 0xFFFF;
+                capture.edges.push_back(static_cast<uint16_t>(edge));
+                next += length;
+            }
+
+            if (!is_ok)
+            {
+                std::printf("%s:%zu: bad capture\n", path, line_number);
+                break;
+            }
+            captures.push_back(std::move(capture));
+        }
+        line.clear();
+        if (c == EOF)
+        {
+            break;
+        }
+    }
+
+    std::fclose(file);
+    return is_ok;
+}
+
+inline void WriteRHT03Capture(std::FILE* file, const RHT03Capture& capture)
+{
+    for (auto byte : capture.bytes)
+    {
+        std::fprintf(file, "%02X", byte);
+    }
+    for (auto edge : capture.edges)
+    {
+        std::fprintf(file, " %u", static_cast<unsigned>(edge));
+    }
+    std::fprintf(file, "\n");
+}
@@ -0,0 +1,92 @@
+#include "Check.hpp"
+#include "RHT03Decoder.hpp"
+#include <vector>
+
+namespace
+{
+    constexpr std::array<uint8_t, rht03_frame_bytes> frame{ 0x02, 0x8C, 0x01, 0x5F, 0xEE };    // 65.2 %, 35.1 C
+    constexpr RHT03Timing fast_clock{ .ack_low = 48, .ack_high = 48, .bit_low = 30, .zero_high = 16, .one_high = 42, .end_low = 30 };
+    constexpr RHT03Timing stretched{ .bit_low = 44, .zero_high = 52, .one_high = 90 };
+
+    bool DecodesAs(std::span<const uint16_t> edges, RHT03Status status, int32_t humidity = 0, int32_t temp = 0,
+        RHT03BitClassifier classifier = RHT03BitClassifier::TwoCluster)
+    {
+        const auto result = DecodeRHT03(edges, classifier);
+        return result.status == status
+            && (status != RHT03Status::Ok || (result.reading.humidity.Raw() == humidity && result.reading.temp.Raw() == temp));
+    }
+
+    void CheckReadings()
+    {
+        CHECK(DecodesAs(MakeRHT03Edges(frame, 0), RHT03Status::Ok, 652, 351));
+        CHECK(DecodesAs(MakeRHT03Edges({ 0x02, 0x8C, 0x80, 0x65, 0x73 }, 1000), RHT03Status::Ok, 652, -101));
+        // Every bit the same, so there is nothing to split and the lows decide.
+        CHECK(DecodesAs(MakeRHT03Edges({ 0, 0, 0, 0, 0 }, 0), RHT03Status::Ok, 0, 0));
+
+        const auto result = DecodeRHT03(MakeRHT03Edges(frame, 0));
+        CHECK(result.threshold_us == 48);
+        CHECK(result.margin_us == 21);
+    }
+
+    // The counter wraps at every point of the frame, including on an edge.
+    void CheckWrapAround()
+    {
+        for (uint32_t start = 0x10000 - 6000; start < 0x10000; start += 7)
+        {
+            CHECK(DecodesAs(MakeRHT03Edges(frame, static_cast<uint16_t>(start)), RHT03Status::Ok, 652, 351));
+        }
+        CHECK(DecodesAs(MakeRHT03Edges(frame, 0xFFFF - 30 - 80), RHT03Status::Ok, 652, 351));
+    }
+
+    // Edges before the frame, e.g. a glitch as the host releases the line, are ignored.
+    void CheckLeadingEdges()
+    {
+        const auto frame_edges = MakeRHT03Edges(frame, 100);
+        std::vector<uint16_t> edges{ 10, 20, 30 };
+        edges.insert(edges.end(), frame_edges.begin(), frame_edges.end());
+        CHECK(DecodesAs(edges, RHT03Status::Ok, 652, 351));
+    }
+
+    void CheckMalformedFrames()
+    {
+        CHECK(DecodeRHT03({}).status == RHT03Status::MissingEdges);
+        const auto edges = MakeRHT03Edges(frame, 0);
+        // One edge short, with the release dropped so the frame ends early rather than starting late.
+        CHECK(DecodesAs(std::span{ edges }.subspan(1, rht03_frame_edges - 1), RHT03Status::MissingEdges));
+
+        CHECK(DecodesAs(MakeRHT03Edges({ 0x02, 0x8C, 0x01, 0x5F, 0xEF }, 0), RHT03Status::ChecksumMismatch));
+        CHECK(DecodesAs(MakeRHT03Edges(frame, 0, { .ack_low = 200 }), RHT03Status::BadAcknowledge));
+        CHECK(DecodesAs(MakeRHT03Edges(frame, 0, { .ack_high = 20 }), RHT03Status::BadAcknowledge));
+        CHECK(DecodesAs(MakeRHT03Edges(frame, 0, { .one_high = 150 }), RHT03Status::BadBit));
+        CHECK(DecodesAs(MakeRHT03Edges(frame, 0, { .zero_high = 5 }), RHT03Status::BadBit));
+        CHECK(DecodesAs(MakeRHT03Edges(frame, 0, { .bit_low = 100 }), RHT03Status::BadBit));
+
+        // One late rising edge in the middle of the frame, which makes a bit's low too long.
+        auto glitched = MakeRHT03Edges(frame, 0);
+        glitched[40] = static_cast<uint16_t>(glitched[40] + 45);
+        CHECK(DecodesAs(glitched, RHT03Status::BadBit));
+    }
+
+    void CheckClassifiers()
+    {
+        // A sensor clock 40 % fast squashes every high below the fixed threshold, which reads all 0s and even passes
+        // the checksum. The frame's own lows still tell the bits apart.
+        CHECK(DecodesAs(MakeRHT03Edges(frame, 0, fast_clock), RHT03Status::Ok, 0, 0, RHT03BitClassifier::FixedThreshold));
+        CHECK(DecodesAs(MakeRHT03Edges(frame, 0, fast_clock), RHT03Status::Ok, 652, 351, RHT03BitClassifier::LowRatio));
+        CHECK(DecodesAs(MakeRHT03Edges(frame, 0, fast_clock), RHT03Status::Ok, 652, 351));
+
+        // A slow rising edge stretches the highs past the lows. Only the split follows it.
+        CHECK(DecodesAs(MakeRHT03Edges(frame, 0, stretched), RHT03Status::ChecksumMismatch, 0, 0, RHT03BitClassifier::LowRatio));
+        CHECK(DecodesAs(MakeRHT03Edges(frame, 0, stretched), RHT03Status::Ok, 652, 351));
+    }
+}
+
+int main()
+{
+    CheckReadings();
+    CheckWrapAround();
+    CheckLeadingEdges();
+    CheckMalformedFrames();
+    CheckClassifiers();
+    return CheckResult();
+}